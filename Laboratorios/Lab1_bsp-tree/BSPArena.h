@@ -0,0 +1,107 @@
+// Archivo: BSPArena.h
+// Recurso de memoria monotónico para BSPTree (std::pmr). Reparte memoria de
+// bloques grandes avanzando un puntero; liberar un objeto no hace nada y todo
+// se recupera de una vez con reset() o release().
+//
+// Uso típico por nivel:
+//     BSPArena arena;
+//     BSPTree<> tree(&arena);
+//     ... construir y usar el árbol ...
+//     tree.clear();   // O(1): no recorre nodos
+//     arena.reset();  // O(1) por bloque: los bloques se reutilizan en el siguiente nivel
+//
+// La arena debe vivir más que cualquier árbol o polígono que la use.
+#ifndef BSPARENA_H
+#define BSPARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+class BSPArena : public std::pmr::memory_resource {
+private:
+    struct Chunk {
+        char* data;
+        size_t size;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    size_t chunkSize_;
+    std::vector<Chunk> chunks_;
+    size_t current_;      // bloque en uso
+    size_t offset_;       // bytes usados del bloque en uso
+    size_t used_;         // bytes entregados desde el último reset()
+
+    static constexpr size_t kChunkAlign = alignof(std::max_align_t);
+
+    // Intenta servir la petición desde el bloque en uso
+    void* tryAllocate(size_t bytes, size_t alignment) {
+        if (current_ >= chunks_.size()) return nullptr;
+        const Chunk& chunk = chunks_[current_];
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunk.data);
+        std::uintptr_t start = (base + offset_ + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        size_t end = static_cast<size_t>(start - base) + bytes;
+        if (end > chunk.size) return nullptr;
+        offset_ = end;
+        used_ += bytes;
+        return reinterpret_cast<void*>(start);
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (void* p = tryAllocate(bytes, alignment)) return p;
+        // Pasar a los bloques siguientes ya reservados (tras un reset()) o pedir uno nuevo
+        while (current_ + 1 < chunks_.size()) {
+            ++current_;
+            offset_ = 0;
+            if (void* p = tryAllocate(bytes, alignment)) return p;
+        }
+        size_t size = std::max(chunkSize_, bytes + alignment);
+        chunks_.push_back({static_cast<char*>(upstream_->allocate(size, kChunkAlign)), size});
+        current_ = chunks_.size() - 1;
+        offset_ = 0;
+        return tryAllocate(bytes, alignment);
+    }
+
+    // Monotónico: la memoria solo se recupera con reset() o release()
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit BSPArena(size_t chunkSize = size_t(1) << 20,
+                      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream), chunkSize_(chunkSize), current_(0), offset_(0), used_(0) {}
+
+    ~BSPArena() override { release(); }
+
+    BSPArena(const BSPArena&) = delete;
+    BSPArena& operator=(const BSPArena&) = delete;
+
+    // Vuelve al principio conservando los bloques reservados
+    void reset() {
+        current_ = 0;
+        offset_ = 0;
+        used_ = 0;
+    }
+
+    // Devuelve todos los bloques al recurso de origen
+    void release() {
+        for (const Chunk& chunk : chunks_) upstream_->deallocate(chunk.data, chunk.size, kChunkAlign);
+        chunks_.clear();
+        reset();
+    }
+
+    size_t bytesUsed() const { return used_; }
+    size_t bytesReserved() const {
+        size_t total = 0;
+        for (const Chunk& chunk : chunks_) total += chunk.size;
+        return total;
+    }
+};
+
+#endif // BSPARENA_H
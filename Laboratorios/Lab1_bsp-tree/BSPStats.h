@@ -0,0 +1,75 @@
+// Archivo: BSPStats.h
+// Estadísticas de BSPTree.
+//  - BSPTreeHealth: forma del árbol (profundidades, nodos, polígonos por nodo,
+//    fragmentación). Se calcula bajo demanda con BSPTree::health().
+//  - BSPQueryStats: contadores de una consulta. Solo se llenan si se compila con
+//    BSP_ENABLE_STATS; sin él, la estructura está vacía y BSP_STAT(...) no
+//    genera código.
+#ifndef BSPSTATS_H
+#define BSPSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#if defined(BSP_ENABLE_STATS)
+    #define BSP_STAT(expr) do { expr; } while (0)
+#else
+    #define BSP_STAT(expr) do { } while (0)
+#endif
+
+struct BSPTreeHealth {
+    size_t nodeCount = 0;
+    size_t maxDepth = 0;                 // la raíz tiene profundidad 1
+    std::vector<size_t> depthHistogram;  // depthHistogram[d] = nodos con profundidad d + 1
+    size_t insertedPolygons = 0;         // polígonos recibidos por insert()
+    size_t storedPolygons = 0;           // fragmentos guardados en los nodos
+    size_t maxPolygonsPerNode = 0;
+
+    double polygonsPerNode() const {
+        return nodeCount ? static_cast<double>(storedPolygons) / static_cast<double>(nodeCount) : 0.0;
+    }
+    // Fragmentos por polígono de entrada (1.0 = ningún corte)
+    double fragmentRatio() const {
+        return insertedPolygons ? static_cast<double>(storedPolygons) / static_cast<double>(insertedPolygons) : 0.0;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const BSPTreeHealth& h) {
+    os << "nodes: " << h.nodeCount << ", depth: " << h.maxDepth
+       << ", polygons/node: " << h.polygonsPerNode() << " (max " << h.maxPolygonsPerNode << ")"
+       << ", fragment ratio: " << h.fragmentRatio() << "\n  depth histogram:";
+    for (size_t d = 0; d < h.depthHistogram.size(); ++d) os << " " << d + 1 << ":" << h.depthHistogram[d];
+    return os;
+}
+
+#if defined(BSP_ENABLE_STATS)
+struct BSPQueryStats {
+    uint64_t queries = 0;        // consultas acumuladas en este registro
+    uint64_t nodesVisited = 0;
+    uint64_t planeTests = 0;     // distancias/productos contra planos
+    uint64_t containsCalls = 0;  // llamadas a Polygon::contains
+    uint64_t results = 0;
+
+    BSPQueryStats& operator+=(const BSPQueryStats& o) {
+        queries += o.queries;
+        nodesVisited += o.nodesVisited;
+        planeTests += o.planeTests;
+        containsCalls += o.containsCalls;
+        results += o.results;
+        return *this;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const BSPQueryStats& s) {
+    os << "queries: " << s.queries << ", nodes visited: " << s.nodesVisited
+       << ", plane tests: " << s.planeTests << ", contains: " << s.containsCalls
+       << ", results: " << s.results;
+    return os;
+}
+#else
+struct BSPQueryStats {};
+#endif
+
+#endif // BSPSTATS_H
@@ -1,11 +1,19 @@
 #ifndef BSPTREE_H
 #define BSPTREE_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <functional>
 #include "Plane.h"
 #include "Ball.h"
+#include "BSPArena.h"
+#include "BSPStats.h"
+#include "BSPVisibility.h"
 
 // Forward declarations
 template <typename T>
@@ -14,32 +22,76 @@ class BSPNode;
 template <typename T>
 class BSPTree;
 
+// Buffers de corte reutilizables, uno por nivel de recursión: el corte en el
+// nivel d escribe en los buffers de d mientras sus fragmentos se insertan en
+// niveles más profundos. Tras calentarse, cortar no reserva memoria.
+// std::deque mantiene válidas las referencias a niveles ya creados al crecer.
+template <typename T = NType>
+class SplitScratch {
+private:
+    std::deque<std::pair<std::vector<Point3D<T>>, std::vector<Point3D<T>>>> levels_;
+
+public:
+    std::pair<std::vector<Point3D<T>>, std::vector<Point3D<T>>>& at(size_t depth) {
+        while (levels_.size() <= depth) levels_.emplace_back();
+        return levels_[depth];
+    }
+};
+
 // BSPNode class template
+// Los hijos, los polígonos y sus vértices se reservan en el mismo recurso de
+// memoria que el nodo (el heap por defecto, o la arena del BSPTree).
 template <typename T = NType>
 class BSPNode {
 private:
     Plane<T> partition_;
-    std::unique_ptr<BSPNode<T>> front_;
-    std::unique_ptr<BSPNode<T>> back_;
-    std::vector<Polygon<T>> polygons_;
+    BSPNode<T>* front_;
+    BSPNode<T>* back_;
+    std::pmr::vector<Polygon<T>> polygons_;
+
+    std::pmr::memory_resource* resource() const { return polygons_.get_allocator().resource(); }
+
+    BSPNode<T>* makeChild() {
+        std::pmr::polymorphic_allocator<BSPNode<T>> alloc(resource());
+        BSPNode<T>* child = alloc.allocate(1);
+        return new (child) BSPNode<T>(resource());
+    }
+
+    static void destroy(BSPNode<T>* node) {
+        if (!node) return;
+        std::pmr::polymorphic_allocator<BSPNode<T>> alloc(node->resource());
+        node->~BSPNode();
+        alloc.deallocate(node, 1);
+    }
 
 public:
-    BSPNode() : partition_(), front_(nullptr), back_(nullptr) {}
-    ~BSPNode() = default;
+    BSPNode() : BSPNode(std::pmr::get_default_resource()) {}
+    explicit BSPNode(std::pmr::memory_resource* resource)
+        : partition_(), front_(nullptr), back_(nullptr), polygons_(resource) {}
+    ~BSPNode() {
+        destroy(front_);
+        destroy(back_);
+    }
 
     BSPNode(const BSPNode&) = delete;
     BSPNode& operator=(const BSPNode&) = delete;
 
     // Getters
     const Plane<T>& getPartition() const { return partition_; }
-    const std::vector<Polygon<T>>& getPolygons() const { return polygons_; }
-    const BSPNode<T>* getFront() const { return front_.get(); }
-    const BSPNode<T>*  getBack() const { return  back_.get(); }
+    const std::pmr::vector<Polygon<T>>& getPolygons() const { return polygons_; }
+    const BSPNode<T>* getFront() const { return front_; }
+    const BSPNode<T>*  getBack() const { return  back_; }
 
+    // Inserta el polígono usando un scratch por hilo, que se reutiliza entre
+    // llamadas (BSPTree::insert usa el suyo propio).
     void insert(const Polygon<T>& polygon);
+    // Inserta el polígono (verts, n); los cortes usan los buffers de 'scratch' desde el nivel 'depth'
+    void insert(const Point3D<T>* verts, size_t n, SplitScratch<T>& scratch, size_t depth);
 
     // Método de consulta: recolecta en 'results' los polígonos que pueden colisionar con la Ball.
-    void query(const Ball<T>& ball, const LineSegment<T>& movement, std::vector<Polygon<T>>& results) const;
+    // Con BSP_ENABLE_STATS y 'stats' no nulo, acumula los contadores de la consulta.
+    void query(const Ball<T>& ball, const LineSegment<T>& movement, std::vector<Polygon<T>>& results,
+               BSPQueryStats* stats = nullptr) const;
     
     // Print
     void print(std::ostream& os, int indent = 0) const{
@@ -103,20 +155,109 @@ public:
     }
 };
 
+// Tipo de celda que representa un hijo nulo en un árbol sólido
+enum LeafType {
+    EMPTY_LEAF,
+    SOLID_LEAF
+};
+
 // BSPTree class template
+// Con una BSPArena todos los nodos, polígonos y vértices se reservan en ella y
+// clear()/el destructor no recorren el árbol: la memoria se recupera al
+// reiniciar la arena. Con cualquier otro std::pmr::memory_resource (o el heap,
+// por defecto) los nodos se destruyen y liberan uno a uno.
 template <typename T = NType>
 class BSPTree {
 private:
-    std::unique_ptr<BSPNode<T>> root_;
+    BSPNode<T>* root_;
+    std::pmr::memory_resource* resource_;
+    bool arena_;  // recurso monotónico: clear() no destruye los nodos
+    bool solid_;
+    SplitScratch<T> scratch_;
+    size_t insertedPolygons_;
+    std::unique_ptr<BSPVisibility<T>> pvs_;  // nulo hasta computePVS(); insert()/clear() lo invalidan
+#if defined(BSP_ENABLE_STATS)
+    // Muestreo: se registra una de cada sampleEvery_ consultas (0 = ninguna)
+    std::atomic<uint32_t> sampleEvery_;
+    mutable std::atomic<uint64_t> queryTick_;
+    mutable std::atomic<uint64_t> sampled_[5];
+#endif
 
 public:
-    BSPTree() : root_(nullptr) {}
-    ~BSPTree() = default;
+    BSPTree() : BSPTree(std::pmr::get_default_resource(), false) {}
+    // Recurso genérico: puede reutilizar la memoria liberada, así que se libera nodo a nodo
+    explicit BSPTree(std::pmr::memory_resource* resource) : BSPTree(resource, false) {}
+    // Arena monotónica: clear() es O(1) y la memoria se recupera con arena->reset()
+    explicit BSPTree(BSPArena* arena) : BSPTree(arena, true) {}
+    // Sin recurso: el heap, como BSPTree() (evita la ambigüedad entre los dos anteriores)
+    explicit BSPTree(std::nullptr_t) : BSPTree() {}
+    ~BSPTree() { clear(); }
+
+    BSPTree(const BSPTree&) = delete;
+    BSPTree& operator=(const BSPTree&) = delete;
+
+private:
+    BSPTree(std::pmr::memory_resource* resource, bool monotonic)
+        : root_(nullptr),
+          resource_(resource ? resource : std::pmr::get_default_resource()),
+          arena_(monotonic && resource != nullptr),
+          solid_(false),
+          insertedPolygons_(0)
+#if defined(BSP_ENABLE_STATS)
+          , sampleEvery_(0), queryTick_(0), sampled_{}
+#endif
+    {}
 
+public:
     void insert(const Polygon<T>& polygon);
+
+    // Vacía el árbol. Con arena es O(1): los nodos no se destruyen uno a uno.
+    void clear();
     
     // Devuelve los polígonos candidatos a colisión con la Ball.
     std::vector<Polygon<T>> query(const Ball<T>& ball, const LineSegment<T>& movement) const;
+    // Igual, sumando a 'stats' los contadores de esta consulta (vacío sin BSP_ENABLE_STATS)
+    std::vector<Polygon<T>> query(const Ball<T>& ball, const LineSegment<T>& movement, BSPQueryStats& stats) const;
+
+    // Forma del árbol: histograma de profundidades, polígonos por nodo y fragmentación
+    BSPTreeHealth health() const;
+
+    // ---- Modo sólido ----
+    // Construye el árbol a partir de una malla cerrada cuyas normales apuntan hacia
+    // fuera (vértices en sentido antihorario vistos desde fuera). Con la misma
+    // partición de insert(), un hijo nulo delante de un plano es una hoja vacía
+    // (fuera del sólido) y uno detrás es una hoja sólida (dentro).
+    void buildSolid(const std::vector<Polygon<T>>& mesh);
+    bool isSolid() const { return solid_; }
+
+    // Hoja que contiene el punto; los puntos sobre un plano se tratan como de
+    // su lado trasero, así que la superficie cuenta como dentro.
+    LeafType leafOf(const Point3D<T>& p) const;
+    bool isInside(const Point3D<T>& p) const { return leafOf(p) == SOLID_LEAF; }
+
+    // ¿La esfera toca el sólido? Solo baja por ambos lados de un plano cuando la
+    // esfera lo cruza. Es conservador cerca de aristas y vértices convexos: la
+    // esfera puede cruzar los planos de ambos sólidos sin tocar el sólido.
+    bool sphereIntersectsSolid(const Ball<T>& ball) const;
+
+    // ---- Visibilidad (PVS) ----
+    // Precalcula celdas, portales y el conjunto potencialmente visible de cada
+    // hoja vacía (ver BSPVisibility.h). Requiere un árbol sólido; 'threads' = 0
+    // usa std::thread::hardware_concurrency().
+    void computePVS(unsigned threads = 0);
+    const BSPVisibility<T>* getVisibility() const { return pvs_.get(); }
+    // Hojas vacías visibles desde el punto (vacío si el punto está en el sólido)
+    std::vector<size_t> visibleLeaves(const Point3D<T>& eye) const;
+    // Polígonos que bordean alguna hoja visible desde el punto, sin repetir
+    std::vector<Polygon<T>> visiblePolygons(const Point3D<T>& eye) const;
+
+#if defined(BSP_ENABLE_STATS)
+    // Modo muestreo para producción: query() sin 'stats' registra una de cada
+    // 'every' consultas en un acumulador compartido (0 lo desactiva).
+    void setQuerySampling(uint32_t every) { sampleEvery_.store(every, std::memory_order_relaxed); }
+    BSPQueryStats sampledQueryStats() const;
+    void resetSampledQueryStats();
+#endif
     
     // Print
     void print(std::ostream& os) const{
@@ -155,33 +296,45 @@ public:
 
 template <typename T>
 void BSPNode<T>::insert(const Polygon<T>& polygon) {
+    thread_local SplitScratch<T> scratch;
+    insert(polygon.vertexData(), polygon.vertexCount(), scratch, 0);
+}
+
+template <typename T>
+void BSPNode<T>::insert(const Point3D<T>* verts, size_t n, SplitScratch<T>& scratch, size_t depth) {
     if (polygons_.empty()) {
-        partition_ = polygon.getPlane();
-        polygons_.push_back(polygon);
+        partition_ = Polygon<T>::planeOf(verts, n);
+        polygons_.emplace_back(verts, n);
         return;
     }
-    RelationType rel = polygon.relationWithPlane(partition_);
+    RelationType rel = Polygon<T>::relationWithPlane(verts, n, partition_);
     switch (rel) {
         case COINCIDENT:
-            polygons_.push_back(polygon);
+            polygons_.emplace_back(verts, n);
             break;
     
         case IN_FRONT:
-            if (!front_) front_ = std::unique_ptr<BSPNode<T>>(new BSPNode<T>());
-            front_->insert(polygon);
+            if (!front_) front_ = makeChild();
+            front_->insert(verts, n, scratch, depth + 1);
             break;
     
         case BEHIND:
-            if (!back_) back_ = std::unique_ptr<BSPNode<T>>(new BSPNode<T>());
-            back_->insert(polygon);
+            if (!back_) back_ = makeChild();
+            back_->insert(verts, n, scratch, depth + 1);
             break;
     
         case SPLIT: {
-            auto splitResult = polygon.split(partition_);
-            if (!front_) front_ = std::unique_ptr<BSPNode<T>>(new BSPNode<T>());
-            front_->insert(splitResult.first);
-            if (!back_) back_ = std::unique_ptr<BSPNode<T>>(new BSPNode<T>());
-            back_->insert(splitResult.second);
+            auto& buffers = scratch.at(depth);
+            Polygon<T>::split(verts, n, partition_, buffers.first, buffers.second);
+            // Un lado puede venir vacío si el corte era degenerado
+            if (!buffers.first.empty()) {
+                if (!front_) front_ = makeChild();
+                front_->insert(buffers.first.data(), buffers.first.size(), scratch, depth + 1);
+            }
+            if (!buffers.second.empty()) {
+                if (!back_) back_ = makeChild();
+                back_->insert(buffers.second.data(), buffers.second.size(), scratch, depth + 1);
+            }
             break;
         }
     
@@ -190,9 +343,11 @@ void BSPNode<T>::insert(const Polygon<T>& polygon) {
     }
 }
 
-
 template <typename T>
-void BSPNode<T>::query(const Ball<T>& ball, const LineSegment<T>& movement, std::vector<Polygon<T>>& results) const {
+void BSPNode<T>::query(const Ball<T>& ball, const LineSegment<T>& movement, std::vector<Polygon<T>>& results,
+                       BSPQueryStats* stats) const {
+    (void)stats;
+    BSP_STAT(if (stats) { ++stats->nodesVisited; stats->planeTests += 2; });
     T r = ball.getRadius();
     T d1 = partition_.distance(movement.getP1());
     T d2 = partition_.distance(movement.getP2());
@@ -204,29 +359,39 @@ void BSPNode<T>::query(const Ball<T>& ball, const LineSegment<T>& movement, std:
 
     if (startInFront || endInFront) {
         if (front_)
-            front_->query(ball, movement, results);
+            front_->query(ball, movement, results, stats);
     }
     if (startBehind || endBehind) {
         if (back_)
-            back_->query(ball, movement, results);
+            back_->query(ball, movement, results, stats);
     }
 
     for (const auto& poly : polygons_) {
         Plane<T> plane = poly.getPlane();
         Vector3D<T> dir = movement.getP2() - movement.getP1();
         T denom = plane.getNormal().dot(dir);
+        BSP_STAT(if (stats) ++stats->planeTests);
 
         if (abs(denom) > T(1e-5)) {
             T t = (plane.getPoint() - movement.getP1()).dot(plane.getNormal()) / denom;
             if (t >= T(0) && t <= T(1)) {
                 Point3D<T> intersection = movement.getP1() + dir * t;
+                BSP_STAT(if (stats) ++stats->containsCalls);
                 if (poly.contains(intersection)) {
                     results.push_back(poly);
+                    BSP_STAT(if (stats) ++stats->results);
                 }
             }
         } else {
-            if (poly.contains(ball.getPosition()) || poly.contains(movement.getP2())) {
+            bool hit = poly.contains(ball.getPosition());
+            BSP_STAT(if (stats) ++stats->containsCalls);
+            if (!hit) {
+                hit = poly.contains(movement.getP2());
+                BSP_STAT(if (stats) ++stats->containsCalls);
+            }
+            if (hit) {
                 results.push_back(poly);
+                BSP_STAT(if (stats) ++stats->results);
             }
         }
     }
@@ -235,19 +400,173 @@ void BSPNode<T>::query(const Ball<T>& ball, const LineSegment<T>& movement, std:
 // ------------------ BSPTree ------------------
 template <typename T>
 void BSPTree<T>::insert(const Polygon<T>& polygon) {
-    if (!root_) root_ = std::unique_ptr<BSPNode<T>>(new BSPNode<T>());
-    root_->insert(polygon);
+    if (!root_) {
+        std::pmr::polymorphic_allocator<BSPNode<T>> alloc(resource_);
+        root_ = new (alloc.allocate(1)) BSPNode<T>(resource_);
+    }
+    root_->insert(polygon.vertexData(), polygon.vertexCount(), scratch_, 0);
+    ++insertedPolygons_;
+    pvs_.reset();
+}
+
+template <typename T>
+void BSPTree<T>::clear() {
+    if (root_ && !arena_) {
+        std::pmr::polymorphic_allocator<BSPNode<T>> alloc(resource_);
+        root_->~BSPNode();
+        alloc.deallocate(root_, 1);
+    }
+    root_ = nullptr;
+    solid_ = false;
+    insertedPolygons_ = 0;
+    pvs_.reset();
+}
+
+template <typename T>
+void BSPTree<T>::buildSolid(const std::vector<Polygon<T>>& mesh) {
+    clear();
+    for (const auto& poly : mesh) insert(poly);
+    solid_ = true;
+}
+
+template <typename T>
+LeafType BSPTree<T>::leafOf(const Point3D<T>& p) const {
+    if (!solid_) throw std::logic_error("BSPTree::leafOf requiere un árbol construido con buildSolid");
+    const BSPNode<T>* node = root_;
+    if (!node) return EMPTY_LEAF;
+    while (true) {
+        if (node->getPartition().side(p) > 0) {
+            if (!node->getFront()) return EMPTY_LEAF;
+            node = node->getFront();
+        } else {
+            if (!node->getBack()) return SOLID_LEAF;
+            node = node->getBack();
+        }
+    }
+}
+
+template <typename T>
+bool BSPTree<T>::sphereIntersectsSolid(const Ball<T>& ball) const {
+    if (!solid_) throw std::logic_error("BSPTree::sphereIntersectsSolid requiere un árbol construido con buildSolid");
+    if (!root_) return false;
+    const T r = ball.getRadius();
+    // Pila por hilo reutilizada entre consultas: tras la primera no reserva memoria
+    thread_local std::vector<const BSPNode<T>*> stack;
+    stack.clear();
+    stack.push_back(root_);
+    while (!stack.empty()) {
+        const BSPNode<T>* node = stack.back();
+        stack.pop_back();
+        T d = node->getPartition().distance(ball.getPosition());
+        if (d > -r) {
+            // Parte de la esfera está delante del plano
+            if (node->getFront()) stack.push_back(node->getFront());
+        }
+        if (d < r) {
+            // Parte de la esfera está detrás: una hoja sólida basta
+            if (!node->getBack()) return true;
+            stack.push_back(node->getBack());
+        }
+    }
+    return false;
+}
+
+template <typename T>
+void BSPTree<T>::computePVS(unsigned threads) {
+    if (!solid_) throw std::logic_error("BSPTree::computePVS requiere un árbol construido con buildSolid");
+    pvs_ = std::make_unique<BSPVisibility<T>>(BSPVisibility<T>::build(root_, threads));
+}
+
+template <typename T>
+std::vector<size_t> BSPTree<T>::visibleLeaves(const Point3D<T>& eye) const {
+    if (!pvs_) throw std::logic_error("BSPTree::visibleLeaves requiere computePVS()");
+    size_t leaf = pvs_->leafOf(eye);
+    if (leaf == BSPVisibility<T>::kNoLeaf) return {};
+    return pvs_->visibleLeaves(leaf);
+}
+
+template <typename T>
+std::vector<Polygon<T>> BSPTree<T>::visiblePolygons(const Point3D<T>& eye) const {
+    std::vector<Polygon<T>> results;
+    std::vector<char> seen(pvs_ ? pvs_->getFaces().size() : 0);
+    for (size_t leaf : visibleLeaves(eye)) {
+        for (uint32_t face : pvs_->leafFaces(leaf)) {
+            if (seen[face]) continue;
+            seen[face] = 1;
+            results.push_back(*pvs_->getFaces()[face]);
+        }
+    }
+    return results;
 }
 
 template <typename T>
 std::vector<Polygon<T>> BSPTree<T>::query(const Ball<T>& ball, const LineSegment<T>& movement) const {
     std::vector<Polygon<T>> results;
+#if defined(BSP_ENABLE_STATS)
+    uint32_t every = sampleEvery_.load(std::memory_order_relaxed);
+    if (every != 0 && queryTick_.fetch_add(1, std::memory_order_relaxed) % every == 0) {
+        BSPQueryStats stats;
+        results = query(ball, movement, stats);
+        const uint64_t values[5] = {stats.queries, stats.nodesVisited, stats.planeTests,
+                                    stats.containsCalls, stats.results};
+        for (int i = 0; i < 5; ++i) sampled_[i].fetch_add(values[i], std::memory_order_relaxed);
+        return results;
+    }
+#endif
     if (root_) root_->query(ball, movement, results);
     return results;
 }
 
+template <typename T>
+std::vector<Polygon<T>> BSPTree<T>::query(const Ball<T>& ball, const LineSegment<T>& movement,
+                                          BSPQueryStats& stats) const {
+    std::vector<Polygon<T>> results;
+    BSP_STAT(++stats.queries);
+    if (root_) root_->query(ball, movement, results, &stats);
+    return results;
+}
 
+template <typename T>
+BSPTreeHealth BSPTree<T>::health() const {
+    BSPTreeHealth h;
+    h.insertedPolygons = insertedPolygons_;
+    std::vector<std::pair<const BSPNode<T>*, size_t>> stack;
+    if (root_) stack.push_back({root_, 1});
+    while (!stack.empty()) {
+        const BSPNode<T>* node = stack.back().first;
+        size_t depth = stack.back().second;
+        stack.pop_back();
+
+        ++h.nodeCount;
+        h.maxDepth = std::max(h.maxDepth, depth);
+        if (h.depthHistogram.size() < depth) h.depthHistogram.resize(depth, 0);
+        ++h.depthHistogram[depth - 1];
+        h.storedPolygons += node->getPolygons().size();
+        h.maxPolygonsPerNode = std::max(h.maxPolygonsPerNode, node->getPolygons().size());
+
+        if (node->getFront()) stack.push_back({node->getFront(), depth + 1});
+        if (node->getBack()) stack.push_back({node->getBack(), depth + 1});
+    }
+    return h;
+}
 
+#if defined(BSP_ENABLE_STATS)
+template <typename T>
+BSPQueryStats BSPTree<T>::sampledQueryStats() const {
+    BSPQueryStats s;
+    s.queries = sampled_[0].load(std::memory_order_relaxed);
+    s.nodesVisited = sampled_[1].load(std::memory_order_relaxed);
+    s.planeTests = sampled_[2].load(std::memory_order_relaxed);
+    s.containsCalls = sampled_[3].load(std::memory_order_relaxed);
+    s.results = sampled_[4].load(std::memory_order_relaxed);
+    return s;
+}
 
+template <typename T>
+void BSPTree<T>::resetSampledQueryStats() {
+    queryTick_.store(0, std::memory_order_relaxed);
+    for (auto& counter : sampled_) counter.store(0, std::memory_order_relaxed);
+}
+#endif
 
 #endif // BSPTREE_H
@@ -0,0 +1,600 @@
+// Archivo: BSPVisibility.h
+// Conjunto potencialmente visible (PVS) de un BSPTree sólido.
+// Etapa offline (BSPTree::computePVS):
+//  1. Cada hoja vacía (hijo delantero nulo) es una celda convexa y recibe un índice.
+//  2. Portales: para cada nodo se toma un cuadrilátero grande sobre su plano,
+//     se recorta a la celda del nodo y se empuja por ambos subárboles; los
+//     fragmentos que terminan en hojas vacías a los dos lados son portales.
+//  3. Visibilidad gruesa: desde cada portal de salida sp se inunda el grafo de
+//     portales cruzando solo los q que quedan (en parte) delante de sp y tales
+//     que sp queda (en parte) detrás de q. Acota las hojas que sp podría ver.
+//  4. Visibilidad fina (flujo de portal a portal, como qvis): dentro de esa
+//     cota se recorren las cadenas de portales recortando en cada paso el
+//     portal destino a la parte visible a través de la fuente y del último
+//     portal cruzado (planos separadores entre ambos), y la fuente a la parte
+//     detrás del destino. Una hoja es visible si algún camino llega con
+//     ventanas no vacías.
+//  5. Cada fila del PVS se guarda comprimida (ceros con longitud de racha).
+// Las hojas se procesan en paralelo con std::thread.
+#ifndef BSPVISIBILITY_H
+#define BSPVISIBILITY_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Plane.h"
+#include "Point.h"
+
+template <typename T>
+class BSPNode;
+
+template <typename T = NType>
+class BSPVisibility {
+public:
+    // Portal entre dos hojas vacías; la normal del plano apunta hacia 'front'
+    struct Portal {
+        std::vector<Point3D<T>> vertices;
+        Plane<T> plane;
+        size_t front;
+        size_t back;
+    };
+
+    static constexpr size_t kNoLeaf = static_cast<size_t>(-1);
+
+    BSPVisibility() = default;
+
+    // Construye hojas, portales y PVS a partir de la raíz de un árbol sólido
+    static BSPVisibility build(const BSPNode<T>* root, unsigned threads = 0);
+
+    size_t leafCount() const { return leafNodes_.size(); }
+    const std::vector<Portal>& getPortals() const { return portals_; }
+
+    // Hoja vacía que contiene el punto, o kNoLeaf si el punto está dentro del sólido
+    size_t leafOf(const Point3D<T>& p) const;
+
+    bool isVisible(size_t from, size_t to) const;
+    std::vector<size_t> visibleLeaves(size_t from) const;
+
+    // Polígonos del árbol que bordean una hoja (punteros a los nodos del árbol)
+    const std::vector<const Polygon<T>*>& getFaces() const { return faces_; }
+    const std::vector<uint32_t>& leafFaces(size_t leaf) const { return leafFaces_.at(leaf); }
+
+    size_t compressedBytes() const { return rows_.size(); }
+    size_t uncompressedBytes() const { return leafCount() * rowBytes(); }
+
+private:
+    const BSPNode<T>* root_ = nullptr;                        // el árbol debe seguir sin cambios
+    std::vector<const BSPNode<T>*> leafNodes_;                 // hoja i = hijo delantero nulo de leafNodes_[i]
+    std::unordered_map<const BSPNode<T>*, size_t> leafIndex_;
+    std::vector<Portal> portals_;
+    std::vector<std::vector<size_t>> leafPortals_;           // portales que tocan cada hoja
+    std::vector<const Polygon<T>*> faces_;
+    std::vector<std::vector<uint32_t>> leafFaces_;
+    std::vector<uint8_t> rows_;                              // filas comprimidas concatenadas
+    std::vector<size_t> rowOffsets_;
+
+    size_t rowBytes() const { return (leafCount() + 7) / 8; }
+
+    struct Fragment {
+        std::vector<Point3D<T>> vertices;
+        size_t leaf;
+    };
+
+    // Ventanas del flujo de portales, en double. Un punto p está delante del
+    // plano si n · p - d > 0.
+    using Winding = std::vector<std::array<double, 3>>;
+    struct ClipPlane {
+        std::array<double, 3> n;
+        double d;
+    };
+    std::vector<Winding> portalWindings_;
+
+    // Estado de un recorrido desde un portal de salida
+    struct Flow {
+        size_t exitPortal;
+        ClipPlane sourcePlane;
+        const std::vector<char>* mightSee;
+        std::vector<char> onPath;
+        std::vector<uint8_t>* row;
+    };
+
+    void indexLeaves(const BSPNode<T>* root);
+    void buildPortals(const BSPNode<T>* root);
+    void buildFaces(const BSPNode<T>* root);
+    std::vector<uint8_t> computeRow(size_t leaf) const;
+    void flow(Flow& state, size_t leaf, const Winding& source, const Winding* pass, const ClipPlane& passPlane) const;
+
+    ClipPlane orientedPlane(size_t portal, bool towardsFront) const;
+    static bool chop(Winding& w, const ClipPlane& plane);
+    static bool clipToSeparators(const Winding& source, const Winding& pass, Winding& target, bool flipClip);
+
+    // Empuja un polígono por el subárbol 'node' (hijo 'isFront' de 'parent') y
+    // devuelve los fragmentos que llegan a hojas vacías.
+    void descend(std::vector<Point3D<T>> verts, const BSPNode<T>* node, const BSPNode<T>* parent,
+                 bool isFront, std::vector<Fragment>& out) const;
+
+    static void compressRow(const std::vector<uint8_t>& row, std::vector<uint8_t>& out);
+    static double signedDistance(const Portal& p, bool towardsFront, const Point3D<T>& v);
+};
+
+// ------------------------------------------------------------------
+// Construcción
+// ------------------------------------------------------------------
+template <typename T>
+BSPVisibility<T> BSPVisibility<T>::build(const BSPNode<T>* root, unsigned threads) {
+    BSPVisibility<T> vis;
+    if (!root) return vis;
+    vis.root_ = root;
+    vis.indexLeaves(root);
+    vis.buildPortals(root);
+    vis.buildFaces(root);
+    for (const auto& portal : vis.portals_) {
+        Winding w;
+        for (const auto& v : portal.vertices)
+            w.push_back({static_cast<double>(rawValue(v.getX())), static_cast<double>(rawValue(v.getY())),
+                         static_cast<double>(rawValue(v.getZ()))});
+        vis.portalWindings_.push_back(std::move(w));
+    }
+
+    const size_t leaves = vis.leafCount();
+    std::vector<std::vector<uint8_t>> rows(leaves);
+    unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<size_t>(workers, std::max<size_t>(1, leaves)));
+    auto work = [&](unsigned w) {
+        for (size_t leaf = w; leaf < leaves; leaf += workers) rows[leaf] = vis.computeRow(leaf);
+    };
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < workers; ++w) pool.emplace_back(work, w);
+    work(0);
+    for (auto& t : pool) t.join();
+
+    vis.rowOffsets_.reserve(leaves + 1);
+    for (const auto& row : rows) {
+        vis.rowOffsets_.push_back(vis.rows_.size());
+        compressRow(row, vis.rows_);
+    }
+    vis.rowOffsets_.push_back(vis.rows_.size());
+    return vis;
+}
+
+template <typename T>
+void BSPVisibility<T>::indexLeaves(const BSPNode<T>* root) {
+    std::vector<const BSPNode<T>*> stack{root};
+    while (!stack.empty()) {
+        const BSPNode<T>* node = stack.back();
+        stack.pop_back();
+        if (!node->getFront()) {
+            leafIndex_[node] = leafNodes_.size();
+            leafNodes_.push_back(node);
+        }
+        if (node->getBack()) stack.push_back(node->getBack());
+        if (node->getFront()) stack.push_back(node->getFront());
+    }
+    leafPortals_.resize(leafNodes_.size());
+    leafFaces_.resize(leafNodes_.size());
+}
+
+template <typename T>
+void BSPVisibility<T>::descend(std::vector<Point3D<T>> verts, const BSPNode<T>* node, const BSPNode<T>* parent,
+                               bool isFront, std::vector<Fragment>& out) const {
+    while (node) {
+        const Plane<T>& plane = node->getPartition();
+        RelationType rel = Polygon<T>::relationWithPlane(verts.data(), verts.size(), plane);
+        if (rel == SPLIT) {
+            std::vector<Point3D<T>> frontVerts, backVerts;
+            Polygon<T>::split(verts.data(), verts.size(), plane, frontVerts, backVerts);
+            if (!backVerts.empty()) descend(std::move(backVerts), node->getBack(), node, false, out);
+            if (frontVerts.empty()) return;
+            verts = std::move(frontVerts);
+            rel = IN_FRONT;
+        }
+        parent = node;
+        isFront = rel != BEHIND;
+        node = isFront ? node->getFront() : node->getBack();
+    }
+    // Detrás de un hijo nulo está el sólido: el fragmento se descarta
+    if (isFront) out.push_back({std::move(verts), leafIndex_.at(parent)});
+}
+
+template <typename T>
+void BSPVisibility<T>::buildPortals(const BSPNode<T>* root) {
+    // Caja de la escena a partir de los polígonos del árbol
+    double lo[3] = {1e300, 1e300, 1e300}, hi[3] = {-1e300, -1e300, -1e300};
+    std::vector<const BSPNode<T>*> all{root};
+    for (size_t i = 0; i < all.size(); ++i) {
+        for (const auto& poly : all[i]->getPolygons()) {
+            for (size_t k = 0; k < poly.vertexCount(); ++k) {
+                const Point3D<T>& v = poly.getVertex(k);
+                const double c[3] = {static_cast<double>(rawValue(v.getX())), static_cast<double>(rawValue(v.getY())),
+                                     static_cast<double>(rawValue(v.getZ()))};
+                for (int a = 0; a < 3; ++a) {
+                    lo[a] = std::min(lo[a], c[a]);
+                    hi[a] = std::max(hi[a], c[a]);
+                }
+            }
+        }
+        if (all[i]->getFront()) all.push_back(all[i]->getFront());
+        if (all[i]->getBack()) all.push_back(all[i]->getBack());
+    }
+    const double center[3] = {(lo[0] + hi[0]) / 2, (lo[1] + hi[1]) / 2, (lo[2] + hi[2]) / 2};
+    const double half = std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                                  (hi[2] - lo[2]) * (hi[2] - lo[2])) + 1.0;
+
+    // Recorrido en profundidad guardando los semiespacios de los ancestros
+    struct Item {
+        const BSPNode<T>* node;
+        std::vector<std::pair<const Plane<T>*, bool>> cell;  // (plano, lado delantero)
+    };
+    std::vector<Item> stack;
+    stack.push_back({root, {}});
+    while (!stack.empty()) {
+        Item item = std::move(stack.back());
+        stack.pop_back();
+        const BSPNode<T>* node = item.node;
+        const Plane<T>& plane = node->getPartition();
+
+        // Cuadrilátero grande sobre el plano, centrado en la proyección del centro de la escena
+        Vector3D<T> n = plane.getNormal();
+        Point3D<T> c(T(static_cast<float>(center[0])), T(static_cast<float>(center[1])), T(static_cast<float>(center[2])));
+        Point3D<T> q = c - n * plane.distance(c);
+        Point3D<T> axis = abs(n.getX()) < T(0.9f) ? Point3D<T>(T(1), T(0), T(0)) : Point3D<T>(T(0), T(1), T(0));
+        Point3D<T> u = n.cross(axis).normalized() * T(static_cast<float>(half));
+        Point3D<T> v = n.cross(u).normalized() * T(static_cast<float>(half));
+        std::vector<Point3D<T>> quad{q - u - v, q - v + u, q + u + v, q + v - u};
+
+        // Recortar a la celda del nodo
+        std::vector<Point3D<T>> frontVerts, backVerts;
+        for (const auto& half_space : item.cell) {
+            if (quad.empty()) break;
+            Polygon<T>::split(quad.data(), quad.size(), *half_space.first, frontVerts, backVerts);
+            quad = half_space.second ? frontVerts : backVerts;
+        }
+
+        if (!quad.empty()) {
+            std::vector<Fragment> frontFrags;
+            descend(quad, node->getFront(), node, true, frontFrags);
+            for (auto& frag : frontFrags) {
+                std::vector<Fragment> pairs;
+                descend(frag.vertices, node->getBack(), node, false, pairs);
+                for (auto& pair : pairs) {
+                    if (pair.vertices.size() < 3) continue;
+                    size_t id = portals_.size();
+                    Plane<T> portalPlane(pair.vertices[0], n);
+                    portals_.push_back({std::move(pair.vertices), portalPlane, frag.leaf, pair.leaf});
+                    leafPortals_[frag.leaf].push_back(id);
+                    leafPortals_[pair.leaf].push_back(id);
+                }
+            }
+        }
+
+        if (node->getFront()) {
+            Item child{node->getFront(), item.cell};
+            child.cell.push_back({&plane, true});
+            stack.push_back(std::move(child));
+        }
+        if (node->getBack()) {
+            Item child{node->getBack(), std::move(item.cell)};
+            child.cell.push_back({&plane, false});
+            stack.push_back(std::move(child));
+        }
+    }
+}
+
+template <typename T>
+void BSPVisibility<T>::buildFaces(const BSPNode<T>* root) {
+    std::vector<const BSPNode<T>*> stack{root};
+    while (!stack.empty()) {
+        const BSPNode<T>* node = stack.back();
+        stack.pop_back();
+        for (const auto& poly : node->getPolygons()) {
+            uint32_t id = static_cast<uint32_t>(faces_.size());
+            faces_.push_back(&poly);
+            // Un polígono es visible desde las hojas hacia las que mira
+            bool facesFront = poly.getNormal().dot(node->getPartition().getNormal()) > T(0);
+            std::vector<Fragment> frags;
+            descend(poly.getVertices(), facesFront ? node->getFront() : node->getBack(), node, facesFront, frags);
+            for (const auto& frag : frags) {
+                auto& list = leafFaces_[frag.leaf];
+                if (list.empty() || list.back() != id) list.push_back(id);
+            }
+        }
+        if (node->getFront()) stack.push_back(node->getFront());
+        if (node->getBack()) stack.push_back(node->getBack());
+    }
+}
+
+template <typename T>
+double BSPVisibility<T>::signedDistance(const Portal& p, bool towardsFront, const Point3D<T>& v) {
+    double d = static_cast<double>(rawValue(p.plane.distance(v)));
+    return towardsFront ? d : -d;
+}
+
+namespace bspvis_detail {
+
+constexpr double kOnEpsilon = 1e-4;
+
+inline double dot(const std::array<double, 3>& a, const std::array<double, 3>& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+} // namespace bspvis_detail
+
+template <typename T>
+std::vector<uint8_t> BSPVisibility<T>::computeRow(size_t source) const {
+    const size_t leaves = leafCount();
+    std::vector<uint8_t> row(rowBytes(), 0);
+    auto mark = [&](size_t leaf) { row[leaf / 8] |= static_cast<uint8_t>(1u << (leaf % 8)); };
+    mark(source);
+
+    // Tolerancia para no descartar portales que se tocan
+    const double tol = bspvis_detail::kOnEpsilon;
+    std::vector<char> mightSee(leaves);
+    std::vector<size_t> queue;
+    Flow state;
+    state.onPath.assign(leaves, 0);
+    state.row = &row;
+    state.mightSee = &mightSee;
+    for (size_t sp : leafPortals_[source]) {
+        const Portal& exit = portals_[sp];
+        bool exitTowardsFront = exit.back == source;  // sentido de salida desde 'source'
+        size_t first = exitTowardsFront ? exit.front : exit.back;
+
+        // Cota gruesa: hojas alcanzables por portales separados por planos de sp
+        std::fill(mightSee.begin(), mightSee.end(), 0);
+        mightSee[source] = 1;
+        mightSee[first] = 1;
+        queue.assign(1, first);
+        while (!queue.empty()) {
+            size_t leaf = queue.back();
+            queue.pop_back();
+            for (size_t qi : leafPortals_[leaf]) {
+                if (qi == sp) continue;
+                const Portal& q = portals_[qi];
+                bool qTowardsFront = q.back == leaf;
+                size_t next = qTowardsFront ? q.front : q.back;
+                if (mightSee[next]) continue;
+
+                // q debe quedar en parte delante del portal de salida...
+                bool ahead = false;
+                for (const auto& v : q.vertices) {
+                    if (signedDistance(exit, exitTowardsFront, v) > tol) { ahead = true; break; }
+                }
+                if (!ahead) continue;
+                // ...y el portal de salida en parte detrás de q
+                bool behind = false;
+                for (const auto& v : exit.vertices) {
+                    if (signedDistance(q, qTowardsFront, v) < -tol) { behind = true; break; }
+                }
+                if (!behind) continue;
+
+                mightSee[next] = 1;
+                queue.push_back(next);
+            }
+        }
+
+        // Flujo fino dentro de la cota
+        state.exitPortal = sp;
+        state.sourcePlane = orientedPlane(sp, exitTowardsFront);
+        state.onPath[source] = 1;
+        flow(state, first, portalWindings_[sp], nullptr, state.sourcePlane);
+        state.onPath[source] = 0;
+    }
+    return row;
+}
+
+// 'source' es la parte del portal de salida que aún puede ver hacia adelante,
+// 'pass' la ventana por la que se entró a 'leaf' (nula en la primera hoja) y
+// 'passPlane' su plano orientado hacia 'leaf'.
+template <typename T>
+void BSPVisibility<T>::flow(Flow& state, size_t leaf, const Winding& source, const Winding* pass,
+                            const ClipPlane& passPlane) const {
+    (*state.row)[leaf / 8] |= static_cast<uint8_t>(1u << (leaf % 8));
+    state.onPath[leaf] = 1;
+    for (size_t qi : leafPortals_[leaf]) {
+        if (qi == state.exitPortal) continue;
+        const Portal& q = portals_[qi];
+        bool qTowardsFront = q.back == leaf;
+        size_t next = qTowardsFront ? q.front : q.back;
+        if (state.onPath[next] || !(*state.mightSee)[next]) continue;
+
+        // El destino debe quedar delante de la fuente y del último portal
+        Winding target = portalWindings_[qi];
+        if (!chop(target, state.sourcePlane) || !chop(target, passPlane)) continue;
+
+        // La fuente que puede ver a través de q es la que queda detrás de q
+        ClipPlane qPlane = orientedPlane(qi, qTowardsFront);
+        ClipPlane behindQ{{-qPlane.n[0], -qPlane.n[1], -qPlane.n[2]}, -qPlane.d};
+        Winding narrowed = source;
+        if (!chop(narrowed, behindQ)) continue;
+
+        // Desde la segunda hoja el destino se recorta a lo que se ve a
+        // través de la fuente y de la ventana de entrada a la vez
+        if (pass) {
+            if (!clipToSeparators(narrowed, *pass, target, false)) continue;
+            if (!clipToSeparators(*pass, narrowed, target, true)) continue;
+        }
+        flow(state, next, narrowed, &target, qPlane);
+    }
+    state.onPath[leaf] = 0;
+}
+
+template <typename T>
+typename BSPVisibility<T>::ClipPlane BSPVisibility<T>::orientedPlane(size_t portal, bool towardsFront) const {
+    const Plane<T>& plane = portals_[portal].plane;
+    Vector3D<T> normal = plane.getNormal();
+    Point3D<T> point = plane.getPoint();
+    ClipPlane cp{{static_cast<double>(rawValue(normal.getX())), static_cast<double>(rawValue(normal.getY())),
+                  static_cast<double>(rawValue(normal.getZ()))}, 0.0};
+    cp.d = bspvis_detail::dot(cp.n, {static_cast<double>(rawValue(point.getX())),
+                                     static_cast<double>(rawValue(point.getY())),
+                                     static_cast<double>(rawValue(point.getZ()))});
+    if (!towardsFront) cp = {{-cp.n[0], -cp.n[1], -cp.n[2]}, -cp.d};
+    return cp;
+}
+
+// Deja en 'w' la parte delante del plano; devuelve false si no queda nada
+// estrictamente delante (los portales que solo se tocan no dejan ver).
+template <typename T>
+bool BSPVisibility<T>::chop(Winding& w, const ClipPlane& plane) {
+    using bspvis_detail::kOnEpsilon;
+    const size_t n = w.size();
+    std::vector<double> dists(n);
+    std::vector<int> sides(n);
+    bool front = false, back = false;
+    for (size_t i = 0; i < n; ++i) {
+        dists[i] = bspvis_detail::dot(plane.n, w[i]) - plane.d;
+        sides[i] = dists[i] > kOnEpsilon ? 1 : dists[i] < -kOnEpsilon ? -1 : 0;
+        front = front || sides[i] > 0;
+        back = back || sides[i] < 0;
+    }
+    if (!front) {
+        w.clear();
+        return false;
+    }
+    if (!back) return true;
+
+    Winding out;
+    out.reserve(n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        size_t j = (i + 1) % n;
+        if (sides[i] >= 0) out.push_back(w[i]);
+        if (sides[i] == 0 || sides[j] == 0 || sides[i] == sides[j]) continue;
+        double t = dists[i] / (dists[i] - dists[j]);
+        out.push_back({w[i][0] + t * (w[j][0] - w[i][0]), w[i][1] + t * (w[j][1] - w[i][1]),
+                       w[i][2] + t * (w[j][2] - w[i][2])});
+    }
+    w.swap(out);
+    return true;
+}
+
+// Recorta 'target' con los planos separadores entre 'source' y 'pass': planos
+// por una arista de 'source' y un vértice de 'pass' que dejan a 'source' de un
+// lado y a 'pass' del otro. Lo que ve 'source' a través de 'pass' queda delante
+// de todos ellos (o detrás, con 'flipClip', cuando se llama con los papeles
+// intercambiados).
+template <typename T>
+bool BSPVisibility<T>::clipToSeparators(const Winding& source, const Winding& pass, Winding& target, bool flipClip) {
+    using bspvis_detail::kOnEpsilon;
+    using bspvis_detail::dot;
+    const size_t ns = source.size(), np = pass.size();
+    for (size_t i = 0; i < ns; ++i) {
+        size_t l = (i + 1) % ns;
+        std::array<double, 3> v1{source[l][0] - source[i][0], source[l][1] - source[i][1], source[l][2] - source[i][2]};
+        for (size_t j = 0; j < np; ++j) {
+            std::array<double, 3> v2{pass[j][0] - source[i][0], pass[j][1] - source[i][1], pass[j][2] - source[i][2]};
+            ClipPlane plane{{v1[1] * v2[2] - v1[2] * v2[1], v1[2] * v2[0] - v1[0] * v2[2], v1[0] * v2[1] - v1[1] * v2[0]}, 0.0};
+            double length = std::sqrt(dot(plane.n, plane.n));
+            if (length < kOnEpsilon) continue;
+            for (double& c : plane.n) c /= length;
+            plane.d = dot(plane.n, pass[j]);
+
+            // Orientar el plano con 'source' detrás
+            size_t k = 0;
+            bool flip = false;
+            for (; k < ns; ++k) {
+                if (k == i || k == l) continue;
+                double d = dot(plane.n, source[k]) - plane.d;
+                if (d < -kOnEpsilon) break;
+                if (d > kOnEpsilon) { flip = true; break; }
+            }
+            if (k == ns) continue;  // coplanar con 'source'
+            if (flip) plane = {{-plane.n[0], -plane.n[1], -plane.n[2]}, -plane.d};
+
+            // Es separador si 'pass' queda entero delante (y no coplanar)
+            bool separates = true, strictlyFront = false;
+            for (k = 0; k < np && separates; ++k) {
+                if (k == j) continue;
+                double d = dot(plane.n, pass[k]) - plane.d;
+                if (d < -kOnEpsilon) separates = false;
+                else if (d > kOnEpsilon) strictlyFront = true;
+            }
+            if (!separates || !strictlyFront) continue;
+
+            if (flipClip) plane = {{-plane.n[0], -plane.n[1], -plane.n[2]}, -plane.d};
+            if (!chop(target, plane)) return false;
+            break;
+        }
+    }
+    return true;
+}
+
+// Bytes distintos de cero tal cual; cada racha de ceros como (0, longitud <= 255)
+template <typename T>
+void BSPVisibility<T>::compressRow(const std::vector<uint8_t>& row, std::vector<uint8_t>& out) {
+    for (size_t i = 0; i < row.size();) {
+        if (row[i] != 0) {
+            out.push_back(row[i++]);
+            continue;
+        }
+        size_t run = 0;
+        while (i < row.size() && row[i] == 0 && run < 255) {
+            ++run;
+            ++i;
+        }
+        out.push_back(0);
+        out.push_back(static_cast<uint8_t>(run));
+    }
+}
+
+// ------------------------------------------------------------------
+// Consultas
+// ------------------------------------------------------------------
+template <typename T>
+size_t BSPVisibility<T>::leafOf(const Point3D<T>& p) const {
+    const BSPNode<T>* node = root_;
+    while (node) {
+        if (node->getPartition().side(p) > 0) {
+            if (!node->getFront()) return leafIndex_.at(node);
+            node = node->getFront();
+        } else {
+            node = node->getBack();
+        }
+    }
+    return kNoLeaf;
+}
+
+template <typename T>
+bool BSPVisibility<T>::isVisible(size_t from, size_t to) const {
+    if (from >= leafCount() || to >= leafCount()) return false;
+    const size_t targetByte = to / 8;
+    size_t byte = 0;
+    for (size_t i = rowOffsets_[from]; i < rowOffsets_[from + 1] && byte <= targetByte;) {
+        if (rows_[i] == 0) {
+            byte += rows_[i + 1];
+            i += 2;
+            continue;
+        }
+        if (byte == targetByte) return (rows_[i] >> (to % 8)) & 1u;
+        ++byte;
+        ++i;
+    }
+    return false;
+}
+
+template <typename T>
+std::vector<size_t> BSPVisibility<T>::visibleLeaves(size_t from) const {
+    std::vector<size_t> leaves;
+    if (from >= leafCount()) return leaves;
+    size_t byte = 0;
+    for (size_t i = rowOffsets_[from]; i < rowOffsets_[from + 1];) {
+        if (rows_[i] == 0) {
+            byte += rows_[i + 1];
+            i += 2;
+            continue;
+        }
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            if ((rows_[i] >> bit) & 1u) leaves.push_back(byte * 8 + bit);
+        }
+        ++byte;
+        ++i;
+    }
+    return leaves;
+}
+
+#endif // BSPVISIBILITY_H
@@ -293,8 +293,29 @@ Safe<T> pow(const Safe<T>& base, const T& exponent) {
     return Safe<T>::pow(base, exponent);
 }
 
+// Sobrecargas de float/double en el espacio global: así el código genérico que
+// llama abs(), sqrt(), ... sin calificar funciona igual con NType = float/double
+// que con Safe<T> (de lo contrario abs(float) resolvería a ::abs(int)).
+using std::abs;
+using std::sqrt;
+using std::acos;
+
+// Valor nativo de un escalar, sea Safe<T> o un tipo aritmético
+template <typename T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0>
+inline T rawValue(const T& v) { return v; }
+template <typename T>
+inline T rawValue(const Safe<T>& v) { return v.getValue(); }
+
 // Typedefs
+// El tipo escalar se elige al compilar (opción BSP_NTYPE de CMake):
+// Safe<float> por defecto, o float/double nativos (versión empaquetada de Point3D).
+#if defined(BSP_NTYPE_DOUBLE)
+using NType = double;
+#elif defined(BSP_NTYPE_FLOAT)
+using NType = float;
+#else
 using NType = Safe<float>;
+#endif
 
 // Relation type
 enum RelationType {
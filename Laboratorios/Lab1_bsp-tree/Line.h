@@ -63,6 +63,9 @@ public:
     Vector3D() : Point3D<T>() {}
     Vector3D(const T& x, const T& y, const T& z) : Point3D<T>(x, y, z) {}
     Vector3D(const Point3D<T>& p) : Point3D<T>(p) {}
+    // Desde una expresión vectorial de PointExpr.h (solo versión genérica)
+    template <typename E, typename = typename std::enable_if<!detail::IsVecLeaf<E>::value>::type>
+    Vector3D(const detail::VecExpr<E>& e) : Point3D<T>(e) {}
     ~Vector3D() = default;
 
     // Dot product
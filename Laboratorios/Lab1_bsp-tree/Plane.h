@@ -5,6 +5,9 @@
 #include "DataType.h"
 #include "Point.h"
 #include "Line.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <memory_resource>
 #include <vector>
 #include <utility>
 #include <stdexcept>
@@ -24,10 +27,23 @@ class Plane {
 private:
     Point3D<T> point_;
     Vector3D<T> normal_;
+    // Si el plano se definió con tres puntos (point_, b_, c_) se clasifica con
+    // orient3d sobre ellos; si no, con la normal almacenada.
+    Point3D<T> b_, c_;
+    bool fromTriangle_;
+
+    static void toDoubles(const Point3D<T>& p, double* out) {
+        out[0] = static_cast<double>(rawValue(p.getX()));
+        out[1] = static_cast<double>(rawValue(p.getY()));
+        out[2] = static_cast<double>(rawValue(p.getZ()));
+    }
 
 public:
-    Plane() : point_(), normal_(Vector3D<T>(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1))) {}
-    Plane(const Point3D<T>& point, const Vector3D<T>& normal) : point_(point), normal_(normal.normalized()) {}
+    Plane() : point_(), normal_(Vector3D<T>(static_cast<T>(0), static_cast<T>(0), static_cast<T>(1))), fromTriangle_(false) {}
+    Plane(const Point3D<T>& point, const Vector3D<T>& normal) : point_(point), normal_(normal.normalized()), fromTriangle_(false) {}
+    // Plano que pasa por a, b y c con normal (b - a) x (c - a)
+    Plane(const Point3D<T>& a, const Point3D<T>& b, const Point3D<T>& c)
+        : point_(a), normal_((b - a).cross(c - a).normalized()), b_(b), c_(c), fromTriangle_(true) {}
 
     T distance(const Point3D<T>& p) const {
         return normal_.dot(p - point_);
@@ -46,6 +62,34 @@ public:
         return abs(distance(p)) < static_cast<T>(1e-3);
     }
 
+    // Clasificación robusta de un punto: +1 delante, -1 detrás, 0 sobre el plano.
+    // El grosor del plano es relativo a la precisión de T (ver Predicates.h).
+    // Con BSP_EPSILON_PREDICATES se usa la tolerancia fija de 1e-3 anterior (solo
+    // para comparar en predicate_report.cpp).
+    int side(const Point3D<T>& p) const {
+#if defined(BSP_EPSILON_PREDICATES)
+        T d = distance(p);
+        if (d > T(1e-3)) return 1;
+        if (d < T(-1e-3)) return -1;
+        return 0;
+#else
+        using Raw = decltype(rawValue(std::declval<T>()));
+        constexpr double relTol = predicates::thickness<Raw>();
+        double q[3], x[3];
+        toDoubles(point_, q);
+        toDoubles(p, x);
+        if (fromTriangle_) {
+            double b[3], c[3];
+            toDoubles(b_, b);
+            toDoubles(c_, c);
+            return predicates::orient3d(q, b, c, x, relTol);
+        }
+        double n[3];
+        toDoubles(normal_, n);
+        return predicates::planeSide(q, n, x, relTol);
+#endif
+    }
+
     bool contains(const Line<T>& l) const {
         return contains(l.getPoint()) && isOrthogonal(normal_, l.getDirection());
     }
@@ -53,8 +97,8 @@ public:
     Point3D<T> getPoint() const { return point_; }
     Vector3D<T> getNormal() const { return normal_; }
 
-    void setPoint(const Point3D<T>& point) { point_ = point; }
-    void setNormal(const Vector3D<T>& normal) { normal_ = normal.normalized(); }
+    void setPoint(const Point3D<T>& point) { point_ = point; fromTriangle_ = false; }
+    void setNormal(const Vector3D<T>& normal) { normal_ = normal.normalized(); fromTriangle_ = false; }
 
     bool operator==(const Plane& other) const {
         bool normalsEqual = (normal_ == other.normal_) || (normal_ == -other.normal_);
@@ -67,22 +111,62 @@ public:
 };
 
 // Polygon class template
+// Los vértices usan un allocator polimórfico (std::pmr): dentro de un BSPTree
+// con arena se guardan en la arena; por defecto, en el heap.
 template <typename T = NType>
 class Polygon {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<Point3D<T>>;
+
 private:
-    std::vector<Point3D<T>> vertices_;
+    std::pmr::vector<Point3D<T>> vertices_;
+
+    // Quita vértices consecutivos repetidos y verifica que los tres primeros
+    // definan un plano (la misma condición que exige getPlane()).
+    static bool isDegenerate(std::vector<Point3D<T>>& verts) {
+        size_t kept = 0;
+        for (size_t i = 0; i < verts.size(); ++i) {
+            if (kept == 0 || !(verts[i] == verts[kept - 1])) verts[kept++] = verts[i];
+        }
+        while (kept > 1 && verts[kept - 1] == verts[0]) --kept;
+        verts.resize(kept);
+        if (kept < 3) return true;
+        return (verts[1] - verts[0]).cross(verts[2] - verts[0]).magnitude() == static_cast<T>(0);
+    }
 
 public:
     Polygon() : vertices_() {}
-    Polygon(const std::vector<Point3D<T>>& vertices) : vertices_(vertices) {}
-
-    std::vector<Point3D<T>> getVertices() const { return vertices_; }
+    explicit Polygon(const allocator_type& alloc) : vertices_(alloc) {}
+    Polygon(const std::vector<Point3D<T>>& vertices, const allocator_type& alloc = {})
+        : vertices_(vertices.begin(), vertices.end(), alloc) {}
+    Polygon(const Point3D<T>* vertices, size_t count, const allocator_type& alloc = {})
+        : vertices_(vertices, vertices + count, alloc) {}
+
+    // Una copia sin allocator explícito vuelve al recurso por defecto
+    Polygon(const Polygon& other) = default;
+    Polygon(Polygon&& other) = default;
+    Polygon(const Polygon& other, const allocator_type& alloc) : vertices_(other.vertices_, alloc) {}
+    Polygon(Polygon&& other, const allocator_type& alloc) : vertices_(std::move(other.vertices_), alloc) {}
+    Polygon& operator=(const Polygon& other) = default;
+    Polygon& operator=(Polygon&& other) = default;
+
+    allocator_type get_allocator() const { return vertices_.get_allocator(); }
+
+    std::vector<Point3D<T>> getVertices() const {
+        return std::vector<Point3D<T>>(vertices_.begin(), vertices_.end());
+    }
+    size_t vertexCount() const { return vertices_.size(); }
+    const Point3D<T>* vertexData() const { return vertices_.data(); }
     const Point3D<T>& getVertex(size_t index) const { return vertices_.at(index); }
     Plane<T> getPlane() const {
-        if (vertices_.size() < 3)
+        return planeOf(vertices_.data(), vertices_.size());
+    }
+
+    // Plano definido por los tres primeros vértices de una secuencia
+    static Plane<T> planeOf(const Point3D<T>* verts, size_t n) {
+        if (n < 3)
             throw std::runtime_error("No se puede definir un plano con menos de 3 vértices.");
-        Vector3D<T> normal = (vertices_[1] - vertices_[0]).cross(vertices_[2] - vertices_[0]).normalized();
-        return Plane<T>(vertices_[0], normal);
+        return Plane<T>(verts[0], verts[1], verts[2]);
     }
     Vector3D<T> getNormal() const {
         return getPlane().getNormal();
@@ -93,7 +177,7 @@ public:
         return sum / static_cast<T>(vertices_.size());
     }
 
-    void setVertices(const std::vector<Point3D<T>>& vertices) { vertices_ = vertices; }
+    void setVertices(const std::vector<Point3D<T>>& vertices) { vertices_.assign(vertices.begin(), vertices.end()); }
 
     bool contains(const Point3D<T>& p) const {
         Plane<T> plane = getPlane();
@@ -113,11 +197,15 @@ public:
     }
 
     RelationType relationWithPlane(const Plane<T>& plane) const {
+        return relationWithPlane(vertices_.data(), vertices_.size(), plane);
+    }
+
+    static RelationType relationWithPlane(const Point3D<T>* verts, size_t n, const Plane<T>& plane) {
         bool inFront = false, behind = false;
-        for (const auto& v : vertices_) {
-            T d = plane.distance(v);
-            if (d > T(1e-3)) inFront = true;
-            else if (d < T(-1e-3)) behind = true;
+        for (size_t i = 0; i < n; ++i) {
+            int s = plane.side(verts[i]);
+            if (s > 0) inFront = true;
+            else if (s < 0) behind = true;
         }
         if (inFront && behind) return SPLIT;
         else if (inFront) return IN_FRONT;
@@ -127,29 +215,60 @@ public:
 
     std::pair<Polygon<T>, Polygon<T>> split(const Plane<T>& plane) const {
         std::vector<Point3D<T>> frontVerts, backVerts;
-        size_t n = vertices_.size();
+        split(plane, frontVerts, backVerts);
+        return {Polygon<T>(frontVerts), Polygon<T>(backVerts)};
+    }
+
+    void split(const Plane<T>& plane, std::vector<Point3D<T>>& frontOut, std::vector<Point3D<T>>& backOut) const {
+        split(vertices_.data(), vertices_.size(), plane, frontOut, backOut);
+    }
 
+    // Corta (verts, n) con el plano y escribe cada lado en los buffers del
+    // llamador; como conservan su capacidad, reutilizarlos evita reservar memoria
+    // en cada corte.
+    // Los vértices sobre el plano van a ambos lados; solo se crea un punto de
+    // corte cuando una arista cruza estrictamente de un lado al otro.
+    // Los puntos de corte se redondean, así que un lado puede quedar degenerado
+    // (vértices repetidos o sin plano definido); en ese caso el polígono completo
+    // va al otro lado y el lado degenerado queda vacío.
+    static void split(const Point3D<T>* verts, size_t n, const Plane<T>& plane,
+                      std::vector<Point3D<T>>& frontOut, std::vector<Point3D<T>>& backOut) {
+        frontOut.clear();
+        backOut.clear();
+        if (n == 0) return;
+
+        // Cada arista aporta a lo sumo un punto de corte a cada lado
+        frontOut.reserve(2 * n);
+        backOut.reserve(2 * n);
+
+        int s1 = plane.side(verts[0]);
         for (size_t i = 0; i < n; ++i) {
-            const auto& current = vertices_[i];
-            const auto& next = vertices_[(i + 1) % n];
-            T d1 = plane.distance(current);
-            T d2 = plane.distance(next);
-
-            bool currInFront = d1 > T(1e-3);
-            bool nextInFront = d2 > T(1e-3);
-
-            if (currInFront) frontVerts.push_back(current);
-            else backVerts.push_back(current);
-
-            if ((currInFront && !nextInFront) || (!currInFront && nextInFront)) {
-                T t = d1 / (d1 - d2);
-                Point3D<T> intersect = current + (next - current) * t;
-                frontVerts.push_back(intersect);
-                backVerts.push_back(intersect);
+            const auto& current = verts[i];
+            const auto& next = verts[(i + 1) % n];
+            int s2 = plane.side(next);
+
+            if (s1 >= 0) frontOut.push_back(current);
+            if (s1 <= 0) backOut.push_back(current);
+
+            if ((s1 > 0 && s2 < 0) || (s1 < 0 && s2 > 0)) {
+                double d1 = static_cast<double>(rawValue(plane.distance(current)));
+                double d2 = static_cast<double>(rawValue(plane.distance(next)));
+                double denom = d1 - d2;
+                double t = denom != 0.0 ? std::min(1.0, std::max(0.0, d1 / denom)) : 0.5;
+                Point3D<T> intersect = current + (next - current) * static_cast<T>(t);
+                frontOut.push_back(intersect);
+                backOut.push_back(intersect);
             }
+            s1 = s2;
         }
 
-        return {Polygon<T>(frontVerts), Polygon<T>(backVerts)};
+        if (isDegenerate(backOut)) {
+            backOut.clear();
+            frontOut.assign(verts, verts + n);
+        } else if (isDegenerate(frontOut)) {
+            frontOut.clear();
+            backOut.assign(verts, verts + n);
+        }
     }
 
     T area() const {
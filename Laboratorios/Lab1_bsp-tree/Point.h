@@ -2,100 +2,103 @@
 #define POINT_H
 
 #include "DataType.h"
+#include "PointExpr.h"
 #include <iostream>
 #include <stdexcept>
-
-template <typename T = NType>
-class Point3D {
+#include <type_traits>
+
+// Versión genérica (Safe<T>, etc.). Para float/double existe una
+// especialización empaquetada con SIMD en PointSIMD.h.
+// Las operaciones +, -, * y / entre puntos devuelven plantillas de expresión
+// (PointExpr.h) que se evalúan en un solo recorrido al asignarse.
+template <typename T, typename>
+class Point3D : public detail::VecExpr<Point3D<T>> {
 private:
-    T x_, y_, z_;
+    T c_[3];
 
 public:
+    using value_type = T;
+
     // Constructors
-    Point3D() : x_(static_cast<T>(0)), y_(static_cast<T>(0)), z_(static_cast<T>(0)) {}
-    Point3D(const T& x, const T& y, const T& z) : x_(x), y_(y), z_(z) {}
+    Point3D() : c_{static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)} {}
+    Point3D(const T& x, const T& y, const T& z) : c_{x, y, z} {}
+
+    // Construcción a partir de una expresión: evalúa cada componente una vez
+    template <typename E, typename = typename std::enable_if<!detail::IsVecLeaf<E>::value>::type>
+    Point3D(const detail::VecExpr<E>& e) : c_{e.self()[0], e.self()[1], e.self()[2]} {}
+
+    template <typename E, typename = typename std::enable_if<!detail::IsVecLeaf<E>::value>::type>
+    Point3D& operator=(const detail::VecExpr<E>& e) {
+        // Cada componente solo depende de la misma componente de los operandos,
+        // así que asignar en el sitio es correcto aunque la expresión use *this
+        for (std::size_t i = 0; i < 3; ++i) c_[i] = e.self()[i];
+        return *this;
+    }
 
     // Getters
-    inline const T& getX() const { return x_; }
-    inline const T& getY() const { return y_; }
-    inline const T& getZ() const { return z_; }
+    inline const T& getX() const { return c_[0]; }
+    inline const T& getY() const { return c_[1]; }
+    inline const T& getZ() const { return c_[2]; }
+    inline const T& operator[](std::size_t i) const { return c_[i]; }
 
     // Setters
-    inline void setX(const T& x) { x_ = x; }
-    inline void setY(const T& y) { y_ = y; }
-    inline void setZ(const T& z) { z_ = z; }
+    inline void setX(const T& x) { c_[0] = x; }
+    inline void setY(const T& y) { c_[1] = y; }
+    inline void setZ(const T& z) { c_[2] = z; }
 
     // Operator Overloads
     bool operator==(const Point3D& p) const {
-        return x_ == p.x_ && y_ == p.y_ && z_ == p.z_;
+        return c_[0] == p.c_[0] && c_[1] == p.c_[1] && c_[2] == p.c_[2];
     }
     bool operator!=(const Point3D& p) const {
         return !(*this == p);
     }
 
-    Point3D operator+(const Point3D& p) const {
-        return Point3D(x_ + p.x_, y_ + p.y_, z_ + p.z_);
-    }
-    Point3D operator-(const Point3D& p) const {
-        return Point3D(x_ - p.x_, y_ - p.y_, z_ - p.z_);
-    }
-    Point3D operator*(const T& scalar) const {
-        return Point3D(x_ * scalar, y_ * scalar, z_ * scalar);
-    }
-    Point3D operator/(const T& scalar) const {
-        if (scalar == static_cast<T>(0)) {
-            throw std::runtime_error("Division by zero");
-        }
-        return Point3D(x_ / scalar, y_ / scalar, z_ / scalar);
-    }
-
     // Compound Assignment Operators
-    Point3D& operator+=(const Point3D& p) {
-        x_ += p.x_;
-        y_ += p.y_;
-        z_ += p.z_;
+    template <typename E>
+    Point3D& operator+=(const detail::VecExpr<E>& p) {
+        for (std::size_t i = 0; i < 3; ++i) c_[i] += p.self()[i];
         return *this;
     }
-    Point3D& operator-=(const Point3D& p) {
-        x_ -= p.x_;
-        y_ -= p.y_;
-        z_ -= p.z_;
+    template <typename E>
+    Point3D& operator-=(const detail::VecExpr<E>& p) {
+        for (std::size_t i = 0; i < 3; ++i) c_[i] -= p.self()[i];
         return *this;
     }
     Point3D& operator*=(const T& scalar) {
-        x_ *= scalar;
-        y_ *= scalar;
-        z_ *= scalar;
+        c_[0] *= scalar;
+        c_[1] *= scalar;
+        c_[2] *= scalar;
         return *this;
     }
     Point3D& operator/=(const T& scalar) {
         if (scalar == static_cast<T>(0)) {
             throw std::runtime_error("Division by zero");
         }
-        x_ /= scalar;
-        y_ /= scalar;
-        z_ /= scalar;
+        c_[0] /= scalar;
+        c_[1] /= scalar;
+        c_[2] /= scalar;
         return *this;
     }
 
     // Vector Operations
     // Dot Product
     T dot(const Point3D& p) const {
-        return x_ * p.x_ + y_ * p.y_ + z_ * p.z_;
+        return c_[0] * p.c_[0] + c_[1] * p.c_[1] + c_[2] * p.c_[2];
     }
 
     // Cross Product
     Point3D cross(const Point3D& p) const {
         return Point3D(
-            y_ * p.z_ - z_ * p.y_,
-            z_ * p.x_ - x_ * p.z_,
-            x_ * p.y_ - y_ * p.x_
+            c_[1] * p.c_[2] - c_[2] * p.c_[1],
+            c_[2] * p.c_[0] - c_[0] * p.c_[2],
+            c_[0] * p.c_[1] - c_[1] * p.c_[0]
         );
     }
 
     // Length of the Vector
     T magnitude() const {
-        return sqrt(x_ * x_ + y_ * y_ + z_ * z_);
+        return sqrt(c_[0] * c_[0] + c_[1] * c_[1] + c_[2] * c_[2]);
     }
 
     // Normalization
@@ -135,15 +138,18 @@ public:
 
     // Stream Output Operator
     friend std::ostream& operator<<(std::ostream& os, const Point3D& p) {
-        os << "(" << p.x_ << ", " << p.y_ << ", " << p.z_ << ")";
+        os << "(" << p.c_[0] << ", " << p.c_[1] << ", " << p.c_[2] << ")";
         return os;
     }
 };
 
-// Scalar Multiplication from Left
+// Scalar Multiplication from Left (versión empaquetada; la genérica usa PointExpr.h)
 template <typename T>
-Point3D<T> operator*(const T& scalar, const Point3D<T>& p) {
+typename std::enable_if<std::is_floating_point<T>::value, Point3D<T>>::type
+operator*(const T& scalar, const Point3D<T>& p) {
     return p * scalar;
 }
 
+#include "PointSIMD.h"
+
 #endif // POINT_H
@@ -0,0 +1,175 @@
+// Archivo: PointExpr.h
+// Plantillas de expresión para la versión genérica de Point3D (Safe<T>, etc.).
+// Una expresión como 'a + (b - a) * t' no crea puntos intermedios: se construye
+// un árbol de nodos ligeros que se evalúa componente a componente, en un solo
+// recorrido, al asignarse a un Point3D/Vector3D.
+//
+// Los operandos que son puntos con nombre (lvalues) se guardan por referencia;
+// los temporales (resultado de cross(), normalized(), ...) y los nodos de
+// expresión se guardan por valor, así que 'auto e = p.cross(q) - r;' no deja
+// referencias colgantes. La especialización empaquetada de PointSIMD.h no usa
+// este mecanismo: sus operaciones ya son eager y vectoriales.
+#ifndef POINT_EXPR_H
+#define POINT_EXPR_H
+
+#include "DataType.h"
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename T = NType, typename = void>
+class Point3D;
+
+namespace detail {
+
+// Base CRTP de toda expresión vectorial. E debe definir value_type y
+// operator[](i), que devuelve la componente i ya evaluada.
+template <typename E>
+class VecExpr {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    auto getX() const { return self()[0]; }
+    auto getY() const { return self()[1]; }
+    auto getZ() const { return self()[2]; }
+
+    // Materializa la expresión en un punto
+    auto eval() const { return Point3D<typename E::value_type>(self()); }
+
+    template <typename F>
+    auto dot(const VecExpr<F>& o) const {
+        const E& a = self();
+        const F& b = o.self();
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+    template <typename F>
+    auto cross(const VecExpr<F>& o) const { return eval().cross(o.self().eval()); }
+    auto magnitude() const { return eval().magnitude(); }
+    auto normalized() const { return eval().normalized(); }
+    template <typename F>
+    auto distance(const VecExpr<F>& o) const { return eval().distance(o.self().eval()); }
+};
+
+template <typename E>
+std::true_type isVecExprImpl(const VecExpr<E>*);
+std::false_type isVecExprImpl(...);
+
+// Verdadero para Point3D genérico, Vector3D y los nodos de expresión
+template <typename X>
+using IsVecExpr = decltype(isVecExprImpl(std::declval<typename std::decay<X>::type*>()));
+
+template <typename X, bool = IsVecExpr<X>::value>
+struct IsVecLeaf : std::false_type {};
+template <typename X>
+struct IsVecLeaf<X, true>
+    : std::is_base_of<Point3D<typename std::decay<X>::type::value_type>, typename std::decay<X>::type> {};
+
+// Cómo se guarda un operando: los puntos lvalue por referencia, el resto por valor
+template <typename X>
+using Operand = typename std::conditional<
+    std::is_lvalue_reference<X>::value && IsVecLeaf<X>::value,
+    const typename std::decay<X>::type&,
+    typename std::decay<X>::type>::type;
+
+template <typename X>
+using ValueOf = typename std::decay<X>::type::value_type;
+
+template <typename L, typename R>
+class VecAdd : public VecExpr<VecAdd<L, R>> {
+    L l_;
+    R r_;
+public:
+    using value_type = ValueOf<L>;
+    VecAdd(L l, R r) : l_(std::forward<L>(l)), r_(std::forward<R>(r)) {}
+    value_type operator[](std::size_t i) const { return l_[i] + r_[i]; }
+};
+
+template <typename L, typename R>
+class VecSub : public VecExpr<VecSub<L, R>> {
+    L l_;
+    R r_;
+public:
+    using value_type = ValueOf<L>;
+    VecSub(L l, R r) : l_(std::forward<L>(l)), r_(std::forward<R>(r)) {}
+    value_type operator[](std::size_t i) const { return l_[i] - r_[i]; }
+};
+
+template <typename L>
+class VecScale : public VecExpr<VecScale<L>> {
+public:
+    using value_type = ValueOf<L>;
+    VecScale(L l, const value_type& s) : l_(std::forward<L>(l)), s_(s) {}
+    value_type operator[](std::size_t i) const { return l_[i] * s_; }
+private:
+    L l_;
+    value_type s_;
+};
+
+// La división por cero se comprueba al construir la expresión, igual que antes
+template <typename L>
+class VecDiv : public VecExpr<VecDiv<L>> {
+public:
+    using value_type = ValueOf<L>;
+    VecDiv(L l, const value_type& s) : l_(std::forward<L>(l)), s_(s) {
+        if (s_ == static_cast<value_type>(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+    }
+    value_type operator[](std::size_t i) const { return l_[i] / s_; }
+private:
+    L l_;
+    value_type s_;
+};
+
+template <typename L, typename R>
+using EnableIfVecPair = typename std::enable_if<IsVecExpr<L>::value && IsVecExpr<R>::value>::type;
+
+template <typename X>
+using EnableIfVec = typename std::enable_if<IsVecExpr<X>::value>::type;
+
+} // namespace detail
+
+// Operadores: misma sintaxis que los miembros de Point3D, pero devuelven nodos
+template <typename L, typename R, typename = detail::EnableIfVecPair<L, R>>
+detail::VecAdd<detail::Operand<L&&>, detail::Operand<R&&>> operator+(L&& l, R&& r) {
+    return {std::forward<L>(l), std::forward<R>(r)};
+}
+
+template <typename L, typename R, typename = detail::EnableIfVecPair<L, R>>
+detail::VecSub<detail::Operand<L&&>, detail::Operand<R&&>> operator-(L&& l, R&& r) {
+    return {std::forward<L>(l), std::forward<R>(r)};
+}
+
+template <typename L, typename = detail::EnableIfVec<L>>
+detail::VecScale<detail::Operand<L&&>> operator*(L&& l, const detail::ValueOf<L>& scalar) {
+    return {std::forward<L>(l), scalar};
+}
+
+template <typename R, typename = detail::EnableIfVec<R>>
+detail::VecScale<detail::Operand<R&&>> operator*(const detail::ValueOf<R>& scalar, R&& r) {
+    return {std::forward<R>(r), scalar};
+}
+
+template <typename L, typename = detail::EnableIfVec<L>>
+detail::VecDiv<detail::Operand<L&&>> operator/(L&& l, const detail::ValueOf<L>& scalar) {
+    return {std::forward<L>(l), scalar};
+}
+
+template <typename L, typename R, typename = detail::EnableIfVecPair<L, R>>
+bool operator==(const L& l, const R& r) {
+    return l[0] == r[0] && l[1] == r[1] && l[2] == r[2];
+}
+
+template <typename L, typename R, typename = detail::EnableIfVecPair<L, R>>
+bool operator!=(const L& l, const R& r) {
+    return !(l == r);
+}
+
+template <typename E, typename = typename std::enable_if<!detail::IsVecLeaf<E>::value>::type>
+std::ostream& operator<<(std::ostream& os, const detail::VecExpr<E>& e) {
+    return os << e.eval();
+}
+
+#endif // POINT_EXPR_H
@@ -0,0 +1,309 @@
+// Archivo: PointSIMD.h
+// Especialización de Point3D para tipos de punto flotante nativos (float, double).
+// Las coordenadas se guardan empaquetadas en 4 carriles alineados (x, y, z, 0)
+// para que suma, resta, producto punto/cruz y normalización usen SSE/AVX.
+// Se incluye desde Point.h; definir POINT3D_NO_SIMD fuerza la versión escalar.
+#ifndef POINT_SIMD_H
+#define POINT_SIMD_H
+
+#include "Point.h"
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+#if !defined(POINT3D_NO_SIMD)
+    #if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+        #define POINT3D_SSE 1
+        #include <xmmintrin.h>
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define POINT3D_SSE2 1
+        #include <emmintrin.h>
+    #endif
+    #if defined(__AVX__)
+        #define POINT3D_AVX 1
+        #include <immintrin.h>
+    #endif
+#endif
+
+namespace detail {
+
+// Operaciones sobre los 4 carriles de un punto empaquetado (versión escalar).
+template <typename T>
+struct ScalarOps {
+    static void add(const T* a, const T* b, T* r) {
+        for (int i = 0; i < 4; ++i) r[i] = a[i] + b[i];
+    }
+    static void sub(const T* a, const T* b, T* r) {
+        for (int i = 0; i < 4; ++i) r[i] = a[i] - b[i];
+    }
+    static void mul(const T* a, T s, T* r) {
+        for (int i = 0; i < 4; ++i) r[i] = a[i] * s;
+    }
+    static void div(const T* a, T s, T* r) {
+        for (int i = 0; i < 4; ++i) r[i] = a[i] / s;
+    }
+    static T dot(const T* a, const T* b) {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+    static void cross(const T* a, const T* b, T* r) {
+        T x = a[1] * b[2] - a[2] * b[1];
+        T y = a[2] * b[0] - a[0] * b[2];
+        T z = a[0] * b[1] - a[1] * b[0];
+        r[0] = x; r[1] = y; r[2] = z; r[3] = static_cast<T>(0);
+    }
+};
+
+// Por defecto se usa la versión escalar; float y double se especializan abajo.
+// El carril w siempre vale 0, por eso dot() puede sumar los 4 carriles.
+template <typename T>
+struct PackedOps : ScalarOps<T> {};
+
+#if defined(POINT3D_SSE)
+template <>
+struct PackedOps<float> {
+    static void add(const float* a, const float* b, float* r) {
+        _mm_store_ps(r, _mm_add_ps(_mm_load_ps(a), _mm_load_ps(b)));
+    }
+    static void sub(const float* a, const float* b, float* r) {
+        _mm_store_ps(r, _mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b)));
+    }
+    static void mul(const float* a, float s, float* r) {
+        _mm_store_ps(r, _mm_mul_ps(_mm_load_ps(a), _mm_set1_ps(s)));
+    }
+    static void div(const float* a, float s, float* r) {
+        _mm_store_ps(r, _mm_div_ps(_mm_load_ps(a), _mm_set1_ps(s)));
+    }
+    static float dot(const float* a, const float* b) {
+        __m128 m = _mm_mul_ps(_mm_load_ps(a), _mm_load_ps(b));
+        __m128 shuf = _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 sums = _mm_add_ps(m, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+    static void cross(const float* a, const float* b, float* r) {
+        // (a * b.yzx - a.yzx * b).yzx
+        __m128 va = _mm_load_ps(a);
+        __m128 vb = _mm_load_ps(b);
+        __m128 aYZX = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 bYZX = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 0, 2, 1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(va, bYZX), _mm_mul_ps(aYZX, vb));
+        _mm_store_ps(r, _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1)));
+    }
+};
+#endif
+
+#if defined(POINT3D_AVX)
+template <>
+struct PackedOps<double> {
+    static void add(const double* a, const double* b, double* r) {
+        _mm256_store_pd(r, _mm256_add_pd(_mm256_load_pd(a), _mm256_load_pd(b)));
+    }
+    static void sub(const double* a, const double* b, double* r) {
+        _mm256_store_pd(r, _mm256_sub_pd(_mm256_load_pd(a), _mm256_load_pd(b)));
+    }
+    static void mul(const double* a, double s, double* r) {
+        _mm256_store_pd(r, _mm256_mul_pd(_mm256_load_pd(a), _mm256_set1_pd(s)));
+    }
+    static void div(const double* a, double s, double* r) {
+        _mm256_store_pd(r, _mm256_div_pd(_mm256_load_pd(a), _mm256_set1_pd(s)));
+    }
+    static double dot(const double* a, const double* b) {
+        __m256d m = _mm256_mul_pd(_mm256_load_pd(a), _mm256_load_pd(b));
+        __m128d s = _mm_add_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+    static void cross(const double* a, const double* b, double* r) {
+    #if defined(__AVX2__)
+        __m256d va = _mm256_load_pd(a);
+        __m256d vb = _mm256_load_pd(b);
+        __m256d aYZX = _mm256_permute4x64_pd(va, _MM_SHUFFLE(3, 0, 2, 1));
+        __m256d bYZX = _mm256_permute4x64_pd(vb, _MM_SHUFFLE(3, 0, 2, 1));
+        __m256d c = _mm256_sub_pd(_mm256_mul_pd(va, bYZX), _mm256_mul_pd(aYZX, vb));
+        _mm256_store_pd(r, _mm256_permute4x64_pd(c, _MM_SHUFFLE(3, 0, 2, 1)));
+    #else
+        // AVX sin AVX2 no permuta entre mitades de 128 bits: versión escalar
+        ScalarOps<double>::cross(a, b, r);
+    #endif
+    }
+};
+#elif defined(POINT3D_SSE2)
+// Sin AVX, double usa dos registros SSE2 (x, y) y (z, w)
+template <>
+struct PackedOps<double> {
+    static void add(const double* a, const double* b, double* r) {
+        _mm_store_pd(r,     _mm_add_pd(_mm_load_pd(a),     _mm_load_pd(b)));
+        _mm_store_pd(r + 2, _mm_add_pd(_mm_load_pd(a + 2), _mm_load_pd(b + 2)));
+    }
+    static void sub(const double* a, const double* b, double* r) {
+        _mm_store_pd(r,     _mm_sub_pd(_mm_load_pd(a),     _mm_load_pd(b)));
+        _mm_store_pd(r + 2, _mm_sub_pd(_mm_load_pd(a + 2), _mm_load_pd(b + 2)));
+    }
+    static void mul(const double* a, double s, double* r) {
+        __m128d vs = _mm_set1_pd(s);
+        _mm_store_pd(r,     _mm_mul_pd(_mm_load_pd(a),     vs));
+        _mm_store_pd(r + 2, _mm_mul_pd(_mm_load_pd(a + 2), vs));
+    }
+    static void div(const double* a, double s, double* r) {
+        __m128d vs = _mm_set1_pd(s);
+        _mm_store_pd(r,     _mm_div_pd(_mm_load_pd(a),     vs));
+        _mm_store_pd(r + 2, _mm_div_pd(_mm_load_pd(a + 2), vs));
+    }
+    static double dot(const double* a, const double* b) {
+        __m128d s = _mm_add_pd(_mm_mul_pd(_mm_load_pd(a),     _mm_load_pd(b)),
+                               _mm_mul_pd(_mm_load_pd(a + 2), _mm_load_pd(b + 2)));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+    static void cross(const double* a, const double* b, double* r) {
+        __m128d a01 = _mm_load_pd(a), a23 = _mm_load_pd(a + 2);
+        __m128d b01 = _mm_load_pd(b), b23 = _mm_load_pd(b + 2);
+        __m128d aYZ = _mm_shuffle_pd(a01, a23, 1), bYZ = _mm_shuffle_pd(b01, b23, 1);
+        __m128d aZX = _mm_shuffle_pd(a23, a01, 0), bZX = _mm_shuffle_pd(b23, b01, 0);
+        __m128d xy = _mm_sub_pd(_mm_mul_pd(aYZ, bZX), _mm_mul_pd(aZX, bYZ));
+        __m128d t = _mm_mul_pd(a01, _mm_shuffle_pd(b01, b01, 1));
+        __m128d zw = _mm_move_sd(_mm_setzero_pd(), _mm_sub_sd(t, _mm_unpackhi_pd(t, t)));
+        _mm_store_pd(r, xy);
+        _mm_store_pd(r + 2, zw);
+    }
+};
+#endif
+
+} // namespace detail
+
+// Point3D empaquetado para float, double y long double
+template <typename T>
+class alignas(4 * sizeof(T)) Point3D<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+private:
+    using Ops = detail::PackedOps<T>;
+
+    T v_[4]; // x, y, z y un carril de relleno que siempre vale 0
+
+    struct NoInit {};
+    explicit Point3D(NoInit) {}
+
+public:
+    // Constructors
+    Point3D() : v_{static_cast<T>(0), static_cast<T>(0), static_cast<T>(0), static_cast<T>(0)} {}
+    Point3D(const T& x, const T& y, const T& z) : v_{x, y, z, static_cast<T>(0)} {}
+
+    // Getters
+    inline const T& getX() const { return v_[0]; }
+    inline const T& getY() const { return v_[1]; }
+    inline const T& getZ() const { return v_[2]; }
+
+    // Setters
+    inline void setX(const T& x) { v_[0] = x; }
+    inline void setY(const T& y) { v_[1] = y; }
+    inline void setZ(const T& z) { v_[2] = z; }
+
+    // Operator Overloads
+    bool operator==(const Point3D& p) const {
+        return v_[0] == p.v_[0] && v_[1] == p.v_[1] && v_[2] == p.v_[2];
+    }
+    bool operator!=(const Point3D& p) const {
+        return !(*this == p);
+    }
+
+    Point3D operator+(const Point3D& p) const {
+        Point3D r{NoInit{}};
+        Ops::add(v_, p.v_, r.v_);
+        return r;
+    }
+    Point3D operator-(const Point3D& p) const {
+        Point3D r{NoInit{}};
+        Ops::sub(v_, p.v_, r.v_);
+        return r;
+    }
+    Point3D operator*(const T& scalar) const {
+        Point3D r{NoInit{}};
+        Ops::mul(v_, scalar, r.v_);
+        return r;
+    }
+    Point3D operator/(const T& scalar) const {
+        if (scalar == static_cast<T>(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+        Point3D r{NoInit{}};
+        Ops::div(v_, scalar, r.v_);
+        return r;
+    }
+
+    // Compound Assignment Operators
+    Point3D& operator+=(const Point3D& p) {
+        Ops::add(v_, p.v_, v_);
+        return *this;
+    }
+    Point3D& operator-=(const Point3D& p) {
+        Ops::sub(v_, p.v_, v_);
+        return *this;
+    }
+    Point3D& operator*=(const T& scalar) {
+        Ops::mul(v_, scalar, v_);
+        return *this;
+    }
+    Point3D& operator/=(const T& scalar) {
+        if (scalar == static_cast<T>(0)) {
+            throw std::runtime_error("Division by zero");
+        }
+        Ops::div(v_, scalar, v_);
+        return *this;
+    }
+
+    // Vector Operations
+    T dot(const Point3D& p) const {
+        return Ops::dot(v_, p.v_);
+    }
+
+    Point3D cross(const Point3D& p) const {
+        Point3D r{NoInit{}};
+        Ops::cross(v_, p.v_, r.v_);
+        return r;
+    }
+
+    T magnitude() const {
+        return std::sqrt(Ops::dot(v_, v_));
+    }
+
+    Point3D normalized() const {
+        T mag = magnitude();
+        if (mag == static_cast<T>(0)) {
+            throw std::runtime_error("Cannot normalize a zero vector");
+        }
+        return *this / mag;
+    }
+
+    T distance(const Point3D& p) const {
+        return (*this - p).magnitude();
+    }
+
+    T angle(const Point3D& p) const {
+        T magA = magnitude();
+        T magB = p.magnitude();
+        if (magA == static_cast<T>(0) || magB == static_cast<T>(0)) {
+            throw std::runtime_error("Cannot calculate angle with a zero-length vector");
+        }
+        T cosine = dot(p) / (magA * magB);
+        if (cosine < static_cast<T>(-1)) cosine = static_cast<T>(-1);
+        if (cosine > static_cast<T>( 1)) cosine = static_cast<T>(1);
+        return std::acos(cosine);
+    }
+
+    Point3D lerp(const Point3D& p, const T& t) const {
+        return *this * (static_cast<T>(1) - t) + p * t;
+    }
+
+    // Stream Output Operator
+    friend std::ostream& operator<<(std::ostream& os, const Point3D& p) {
+        os << "(" << p.v_[0] << ", " << p.v_[1] << ", " << p.v_[2] << ")";
+        return os;
+    }
+};
+
+static_assert(sizeof(Point3D<float>) == 16 && alignof(Point3D<float>) == 16,
+              "Point3D<float> debe ocupar un registro SSE");
+static_assert(sizeof(Point3D<double>) == 32 && alignof(Point3D<double>) == 32,
+              "Point3D<double> debe ocupar un registro AVX");
+
+#endif // POINT_SIMD_H
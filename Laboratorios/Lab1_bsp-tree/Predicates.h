@@ -0,0 +1,204 @@
+// Archivo: Predicates.h
+// Predicados geométricos robustos (filtrados) para clasificar puntos contra planos.
+// Primero se evalúa en double junto con una cota de error; si el resultado no es
+// concluyente se recalcula de forma exacta con aritmética de expansiones
+// (Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+// Geometric Predicates", 1997). Las coordenadas float/double se convierten a
+// double sin pérdida, por lo que la decisión es siempre la exacta.
+//
+// Además del signo puro se admite un grosor relativo ('relTol'): los puntos a
+// menos de relTol * (magnitud de la expresión) del plano se consideran sobre él.
+// Así los puntos de corte, que se redondean al guardarse en T, no generan
+// astillas al volver a clasificarse contra el plano que los creó.
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+namespace predicates {
+
+// Épsilon de redondeo de double (media ulp de 1.0)
+constexpr double kEpsilon = std::numeric_limits<double>::epsilon() * 0.5;
+
+// Cotas de error relativo de la evaluación en double
+constexpr double kOrient3dErrBound = (7.0 + 56.0 * kEpsilon) * kEpsilon;
+constexpr double kPlaneSideErrBound = (5.0 + 32.0 * kEpsilon) * kEpsilon;
+
+// ------------------------------------------------------------------
+// Aritmética de expansiones: un número se representa como suma exacta de
+// componentes double que no se solapan, ordenadas por magnitud creciente.
+// La capacidad es fija (sin memoria dinámica). orient3d necesita a lo sumo 193
+// componentes (3 productos de 2 x 16 más la banda de classify) y planeSide 13;
+// cada componente nueva se verifica contra kCapacity también en Release, así
+// que otras composiciones lanzan std::length_error en vez de escribir fuera.
+// ------------------------------------------------------------------
+class Expansion {
+public:
+    static constexpr std::size_t kCapacity = 256;
+
+    Expansion() : size_(0) {}
+    explicit Expansion(double v) : size_(0) { if (v != 0.0) push(v); }
+
+    // a - b exacto (2 componentes)
+    static Expansion difference(double a, double b) {
+        double x = a - b;
+        double bv = a - x;
+        double av = x + bv;
+        double y = (a - av) + (bv - b);
+        Expansion e;
+        if (y != 0.0) e.push(y);
+        if (x != 0.0) e.push(x);
+        return e;
+    }
+
+    // this + b (grow-expansion con eliminación de ceros)
+    Expansion plus(double b) const {
+        Expansion r;
+        double q = b;
+        for (std::size_t i = 0; i < size_; ++i) {
+            double sum = q + c_[i];
+            double bv = sum - q;
+            double av = sum - bv;
+            double err = (q - av) + (c_[i] - bv);
+            if (err != 0.0) r.push(err);
+            q = sum;
+        }
+        if (q != 0.0 || r.size_ == 0) r.push(q);
+        return r;
+    }
+
+    Expansion operator+(const Expansion& f) const {
+        Expansion r = *this;
+        for (std::size_t i = 0; i < f.size_; ++i) r = r.plus(f.c_[i]);
+        return r;
+    }
+
+    Expansion operator-() const {
+        Expansion r = *this;
+        for (std::size_t i = 0; i < r.size_; ++i) r.c_[i] = -r.c_[i];
+        return r;
+    }
+
+    Expansion operator-(const Expansion& f) const { return *this + (-f); }
+
+    // this * b exacto; el producto de dos double es exacto con fma
+    Expansion scaled(double b) const {
+        Expansion r;
+        for (std::size_t i = 0; i < size_; ++i) {
+            double hi = c_[i] * b;
+            double lo = std::fma(c_[i], b, -hi);
+            r = r.plus(lo).plus(hi);
+        }
+        return r;
+    }
+
+    Expansion operator*(const Expansion& f) const {
+        Expansion r;
+        for (std::size_t i = 0; i < f.size_; ++i) r = r + scaled(f.c_[i]);
+        return r;
+    }
+
+    // El signo de una expansión es el de su componente más significativa
+    int sign() const {
+        for (std::size_t i = size_; i > 0; --i) {
+            if (c_[i - 1] > 0.0) return 1;
+            if (c_[i - 1] < 0.0) return -1;
+        }
+        return 0;
+    }
+
+private:
+    double c_[kCapacity];
+    std::size_t size_;
+
+    // Solo se llega aquí por el camino exacto (el lento), así que la
+    // verificación no afecta al filtro rápido.
+    void push(double v) {
+        if (size_ == kCapacity) throw std::length_error("Expansion: se superó kCapacity");
+        c_[size_++] = v;
+    }
+};
+
+// Decide el lado de un valor 'value' (evaluado en double, con cota de error
+// 'errBound') respecto a la banda [-band, band]. Solo si la evaluación rápida no
+// es concluyente se llama a 'exact', que devuelve la expansión exacta del valor.
+template <typename ExactFn>
+inline int classify(double value, double errBound, double band, ExactFn exact) {
+    if (value > band + errBound) return 1;
+    if (value < -(band + errBound)) return -1;
+    if (band > 0.0 && std::fabs(value) < band - errBound) return 0;
+
+    Expansion e = exact();
+    if (band == 0.0) return e.sign();
+    if (e.plus(-band).sign() > 0) return 1;
+    if (e.plus(band).sign() < 0) return -1;
+    return 0;
+}
+
+// Expansión exacta de ((b - a) x (c - a)) · (p - a)
+inline Expansion orient3dExact(const double* a, const double* b, const double* c, const double* p) {
+    Expansion bax = Expansion::difference(b[0], a[0]);
+    Expansion bay = Expansion::difference(b[1], a[1]);
+    Expansion baz = Expansion::difference(b[2], a[2]);
+    Expansion cax = Expansion::difference(c[0], a[0]);
+    Expansion cay = Expansion::difference(c[1], a[1]);
+    Expansion caz = Expansion::difference(c[2], a[2]);
+    Expansion pax = Expansion::difference(p[0], a[0]);
+    Expansion pay = Expansion::difference(p[1], a[1]);
+    Expansion paz = Expansion::difference(p[2], a[2]);
+
+    Expansion nx = bay * caz - baz * cay;
+    Expansion ny = baz * cax - bax * caz;
+    Expansion nz = bax * cay - bay * cax;
+    return pax * nx + pay * ny + paz * nz;
+}
+
+// Lado de p respecto al plano que pasa por a, b, c con normal (b - a) x (c - a).
+// +1 delante (hacia donde apunta la normal), -1 detrás, 0 sobre el plano.
+inline int orient3d(const double* a, const double* b, const double* c, const double* p, double relTol = 0.0) {
+    double bax = b[0] - a[0], bay = b[1] - a[1], baz = b[2] - a[2];
+    double cax = c[0] - a[0], cay = c[1] - a[1], caz = c[2] - a[2];
+    double pax = p[0] - a[0], pay = p[1] - a[1], paz = p[2] - a[2];
+
+    double baycaz = bay * caz, bazcay = baz * cay;
+    double bazcax = baz * cax, baxcaz = bax * caz;
+    double baxcay = bax * cay, baycax = bay * cax;
+
+    double det = pax * (baycaz - bazcay) + pay * (bazcax - baxcaz) + paz * (baxcay - baycax);
+    double permanent = std::fabs(pax) * (std::fabs(baycaz) + std::fabs(bazcay)) +
+                       std::fabs(pay) * (std::fabs(bazcax) + std::fabs(baxcaz)) +
+                       std::fabs(paz) * (std::fabs(baxcay) + std::fabs(baycax));
+    return classify(det, kOrient3dErrBound * permanent, relTol * permanent,
+                    [&] { return orient3dExact(a, b, c, p); });
+}
+
+// Expansión exacta de n · (p - q)
+inline Expansion planeSideExact(const double* q, const double* n, const double* p) {
+    Expansion s;
+    for (int i = 0; i < 3; ++i)
+        s = s + Expansion::difference(p[i], q[i]).scaled(n[i]);
+    return s;
+}
+
+// Lado de p respecto al plano con punto q y normal n (tal como están almacenados)
+inline int planeSide(const double* q, const double* n, const double* p, double relTol = 0.0) {
+    double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+    double s = n[0] * dx + n[1] * dy + n[2] * dz;
+    double permanent = std::fabs(n[0] * dx) + std::fabs(n[1] * dy) + std::fabs(n[2] * dz);
+    return classify(s, kPlaneSideErrBound * permanent, relTol * permanent,
+                    [&] { return planeSideExact(q, n, p); });
+}
+
+// Grosor relativo por defecto para coordenadas guardadas en el tipo U: unas
+// pocas ulps, suficiente para absorber el redondeo de un punto de corte.
+template <typename U>
+constexpr double thickness() {
+    return 8.0 * static_cast<double>(std::numeric_limits<U>::epsilon());
+}
+
+} // namespace predicates
+
+#endif // PREDICATES_H
@@ -0,0 +1,300 @@
+// Benchmark de BSPTree: construcción y consultas contra búsqueda por fuerza bruta.
+// Recorre tamaños de entrada (1k, 10k, ... hasta --max) y distribuciones:
+//   random      triángulos pequeños repartidos uniformemente
+//   grid        caras de una rejilla 3D alineada a los ejes (orden aleatorio)
+//   clustered   triángulos agrupados alrededor de pocos centros
+//   adversarial la misma rejilla insertada ordenada por x, y, z
+// Para cada caso reporta tiempo de construcción, profundidad, fragmentos,
+// memoria (bytes en la arena) y latencia de consulta p50/p99 del árbol y de la
+// fuerza bruta. Los resultados se escriben también en JSON.
+//
+// Uso: BSPTreeBench [--max N] [--queries Q] [--json archivo]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BSPArena.h"
+#include "BSPTree.h"
+#include "Ball.h"
+#include "Plane.h"
+#include "Point.h"
+#include "DataType.h"
+
+namespace {
+
+using P = Point3D<NType>;
+using Clock = std::chrono::steady_clock;
+
+P point(float x, float y, float z) { return P(NType(x), NType(y), NType(z)); }
+
+// Lado de la escena para que la densidad de polígonos no dependa de n
+float sceneExtent(size_t n) { return 10.0f * std::cbrt(static_cast<float>(n)); }
+
+bool addTriangle(std::vector<Polygon<NType>>& polys, float cx, float cy, float cz, std::mt19937& gen) {
+    std::uniform_real_distribution<float> local(-2.0f, 2.0f);
+    P a = point(cx + local(gen), cy + local(gen), cz + local(gen));
+    P b = point(cx + local(gen), cy + local(gen), cz + local(gen));
+    P c = point(cx + local(gen), cy + local(gen), cz + local(gen));
+    if ((b - a).cross(c - a).magnitude() < NType(0.5f)) return false;
+    polys.push_back(Polygon<NType>({a, b, c}));
+    return true;
+}
+
+std::vector<Polygon<NType>> randomTriangles(size_t n, std::mt19937& gen) {
+    float extent = sceneExtent(n);
+    std::uniform_real_distribution<float> center(-extent, extent);
+    std::vector<Polygon<NType>> polys;
+    polys.reserve(n);
+    while (polys.size() < n) addTriangle(polys, center(gen), center(gen), center(gen), gen);
+    return polys;
+}
+
+std::vector<Polygon<NType>> clusteredTriangles(size_t n, std::mt19937& gen) {
+    float extent = sceneExtent(n);
+    std::uniform_real_distribution<float> center(-extent, extent);
+    std::normal_distribution<float> spread(0.0f, extent / 20.0f);
+    std::vector<P> centers;
+    for (int i = 0; i < 8; ++i) centers.push_back(point(center(gen), center(gen), center(gen)));
+    std::uniform_int_distribution<size_t> pick(0, centers.size() - 1);
+    std::vector<Polygon<NType>> polys;
+    polys.reserve(n);
+    while (polys.size() < n) {
+        const P& c = centers[pick(gen)];
+        addTriangle(polys, rawValue(c.getX()) + spread(gen), rawValue(c.getY()) + spread(gen),
+                    rawValue(c.getZ()) + spread(gen), gen);
+    }
+    return polys;
+}
+
+// Caras x, y, z de las celdas de una rejilla g x g x g, ordenadas por posición
+std::vector<Polygon<NType>> gridFaces(size_t n) {
+    size_t g = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(n) / 3.0)));
+    const float s = 10.0f;
+    std::vector<Polygon<NType>> polys;
+    polys.reserve(3 * g * g * g);
+    for (size_t i = 0; i < g && polys.size() < n; ++i) {
+        for (size_t j = 0; j < g && polys.size() < n; ++j) {
+            for (size_t k = 0; k < g && polys.size() < n; ++k) {
+                float x = s * static_cast<float>(i), y = s * static_cast<float>(j), z = s * static_cast<float>(k);
+                polys.push_back(Polygon<NType>({point(x, y, z), point(x, y + s, z), point(x, y + s, z + s), point(x, y, z + s)}));
+                polys.push_back(Polygon<NType>({point(x, y, z), point(x, y, z + s), point(x + s, y, z + s), point(x + s, y, z)}));
+                polys.push_back(Polygon<NType>({point(x, y, z), point(x + s, y, z), point(x + s, y + s, z), point(x, y + s, z)}));
+            }
+        }
+    }
+    polys.resize(std::min(polys.size(), n));
+    return polys;
+}
+
+std::vector<Polygon<NType>> makeInput(const std::string& dist, size_t n, std::mt19937& gen) {
+    if (dist == "random") return randomTriangles(n, gen);
+    if (dist == "clustered") return clusteredTriangles(n, gen);
+    auto polys = gridFaces(n);
+    if (dist == "grid") std::shuffle(polys.begin(), polys.end(), gen);
+    return polys;
+}
+
+// Prueba por polígono de BSPNode::query, aplicada a todos los polígonos
+bool bruteForceHit(const Polygon<NType>& poly, const Ball<NType>& ball, const LineSegment<NType>& movement) {
+    Plane<NType> plane = poly.getPlane();
+    Vector3D<NType> dir = movement.getP2() - movement.getP1();
+    NType denom = plane.getNormal().dot(dir);
+    if (abs(denom) > NType(1e-5f)) {
+        NType t = (plane.getPoint() - movement.getP1()).dot(plane.getNormal()) / denom;
+        if (t >= NType(0) && t <= NType(1)) return poly.contains(movement.getP1() + dir * t);
+        return false;
+    }
+    return poly.contains(ball.getPosition()) || poly.contains(movement.getP2());
+}
+
+struct Query {
+    Ball<NType> ball;
+    LineSegment<NType> movement;
+};
+
+std::vector<Query> makeQueries(const std::vector<Polygon<NType>>& polys, size_t count, std::mt19937& gen) {
+    // Cada consulta cruza el centroide de un polígono de la entrada, así que hay resultados
+    std::uniform_int_distribution<size_t> pick(0, polys.size() - 1);
+    std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 2.0f);
+    std::vector<Query> queries;
+    for (size_t i = 0; i < count; ++i) {
+        P c = polys[pick(gen)].getCentroid();
+        P pos = c + point(offset(gen), offset(gen), offset(gen));
+        Vector3D<NType> vel = c - pos;
+        Ball<NType> ball(pos, vel, NType(radius(gen)));
+        LineSegment<NType> movement = ball.step(NType(2.0f));
+        queries.push_back({ball, movement});
+    }
+    return queries;
+}
+
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t idx = std::min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())));
+    return v[idx];
+}
+
+double microsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Result {
+    std::string distribution;
+    size_t input = 0;
+    double buildMs = 0.0;
+    size_t depth = 0;
+    size_t nodes = 0;
+    size_t fragments = 0;
+    size_t memoryBytes = 0;
+    size_t treeQueries = 0;
+    double treeP50 = 0.0, treeP99 = 0.0, treeHits = 0.0;
+    BSPQueryStats treeStats;  // vacío sin BSP_ENABLE_STATS
+    size_t bruteQueries = 0;
+    double bruteP50 = 0.0, bruteP99 = 0.0, bruteHits = 0.0;
+};
+
+Result runCase(const std::string& dist, size_t n, size_t queryCount, unsigned seed) {
+    std::mt19937 gen(seed);
+    auto polys = makeInput(dist, n, gen);
+    auto queries = makeQueries(polys, queryCount, gen);
+
+    Result r;
+    r.distribution = dist;
+    r.input = polys.size();
+
+    BSPArena arena;
+    BSPTree<NType> tree(&arena);
+    auto start = Clock::now();
+    for (const auto& poly : polys) tree.insert(poly);
+    r.buildMs = microsSince(start) / 1000.0;
+    r.memoryBytes = arena.bytesUsed();
+
+    // Profundidad y fragmentos guardados en los nodos
+    BSPTreeHealth health = tree.health();
+    r.nodes = health.nodeCount;
+    r.depth = health.maxDepth;
+    r.fragments = health.storedPolygons;
+
+    std::vector<double> latencies;
+    size_t hits = 0;
+    for (const auto& q : queries) {
+        auto t0 = Clock::now();
+        auto found = tree.query(q.ball, q.movement, r.treeStats);
+        latencies.push_back(microsSince(t0));
+        hits += found.size();
+    }
+    r.treeQueries = queries.size();
+    r.treeP50 = percentile(latencies, 0.50);
+    r.treeP99 = percentile(latencies, 0.99);
+    r.treeHits = queries.empty() ? 0.0 : static_cast<double>(hits) / static_cast<double>(queries.size());
+
+    // La fuerza bruta es O(n) por consulta: se limita a ~2e7 pruebas de polígono
+    size_t bruteCount = std::min(queries.size(), std::max<size_t>(10, 20000000 / std::max<size_t>(1, polys.size())));
+    latencies.clear();
+    hits = 0;
+    for (size_t i = 0; i < bruteCount; ++i) {
+        auto t0 = Clock::now();
+        size_t found = 0;
+        for (const auto& poly : polys) found += bruteForceHit(poly, queries[i].ball, queries[i].movement) ? 1 : 0;
+        latencies.push_back(microsSince(t0));
+        hits += found;
+    }
+    r.bruteQueries = bruteCount;
+    r.bruteP50 = percentile(latencies, 0.50);
+    r.bruteP99 = percentile(latencies, 0.99);
+    r.bruteHits = bruteCount ? static_cast<double>(hits) / static_cast<double>(bruteCount) : 0.0;
+
+    tree.clear();
+    return r;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(12) << "dist" << std::right << std::setw(9) << "input"
+              << std::setw(11) << "build ms" << std::setw(7) << "depth" << std::setw(10) << "frags"
+              << std::setw(10) << "mem KiB" << std::setw(11) << "tree p50" << std::setw(11) << "tree p99"
+              << std::setw(12) << "brute p50" << std::setw(12) << "brute p99" << "  (us)\n";
+}
+
+void printRow(const Result& r) {
+    std::cout << std::left << std::setw(12) << r.distribution << std::right << std::setw(9) << r.input
+              << std::setw(11) << std::fixed << std::setprecision(1) << r.buildMs
+              << std::setw(7) << r.depth << std::setw(10) << r.fragments
+              << std::setw(10) << r.memoryBytes / 1024
+              << std::setw(11) << std::setprecision(2) << r.treeP50 << std::setw(11) << r.treeP99
+              << std::setw(12) << r.bruteP50 << std::setw(12) << r.bruteP99 << "\n";
+}
+
+std::string toJson(const std::vector<Result>& results) {
+    std::ostringstream os;
+    os << std::setprecision(6) << "{\n  \"benchmark\": \"bsp_tree\",\n";
+#if defined(NDEBUG)
+    os << "  \"build_type\": \"release\",\n";
+#else
+    os << "  \"build_type\": \"debug\",\n";
+#endif
+    os << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        os << "    {\"distribution\": \"" << r.distribution << "\", \"input\": " << r.input
+           << ", \"build_ms\": " << r.buildMs << ", \"depth\": " << r.depth
+           << ", \"nodes\": " << r.nodes << ", \"fragments\": " << r.fragments
+           << ", \"memory_bytes\": " << r.memoryBytes
+           << ", \"tree\": {\"queries\": " << r.treeQueries << ", \"p50_us\": " << r.treeP50
+           << ", \"p99_us\": " << r.treeP99 << ", \"avg_hits\": " << r.treeHits
+#if defined(BSP_ENABLE_STATS)
+           << ", \"nodes_visited\": " << r.treeStats.nodesVisited << ", \"plane_tests\": " << r.treeStats.planeTests
+           << ", \"contains_calls\": " << r.treeStats.containsCalls
+#endif
+           << "}"
+           << ", \"brute_force\": {\"queries\": " << r.bruteQueries << ", \"p50_us\": " << r.bruteP50
+           << ", \"p99_us\": " << r.bruteP99 << ", \"avg_hits\": " << r.bruteHits << "}}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxInput = 100000;
+    size_t queryCount = 200;
+    std::string jsonPath = "bsp_bench.json";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--max" && i + 1 < argc) maxInput = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--queries" && i + 1 < argc) queryCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            std::cerr << "Uso: " << argv[0] << " [--max N] [--queries Q] [--json archivo]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    printHeader();
+    for (size_t n = 1000; n <= maxInput; n *= 10) {
+        for (const char* dist : {"random", "grid", "clustered", "adversarial"}) {
+            try {
+                results.push_back(runCase(dist, n, queryCount, 1234));
+                printRow(results.back());
+            } catch (const std::exception& e) {
+                std::cerr << "[EXCEPCIÓN] " << dist << " @" << n << ": " << e.what() << "\n";
+            }
+        }
+    }
+
+    std::ofstream out(jsonPath);
+    out << toJson(results);
+    std::cout << "\nResultados JSON en " << jsonPath << "\n";
+    return 0;
+}
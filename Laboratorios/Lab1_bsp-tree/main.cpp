@@ -1,10 +1,15 @@
 #include <iostream>
 #include <random>
 #include <vector>
+#include <atomic>
 #include <cassert>
 #include <cmath>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
 #include <algorithm>
 #include "BSPTree.h"
+#include "BSPArena.h"
 #include "Ball.h"
 #include "Plane.h"
 #include "Point.h"
@@ -12,13 +17,45 @@
 #include "Line.h"
 
 
+// ---------------------------------------------------------------------
+// Contador de reservas del heap (operator new global), para los tests 8 y 10
+// ---------------------------------------------------------------------
+static std::atomic<size_t> gHeapAllocations{0};
+
+void* operator new(std::size_t size) {
+    gHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+
+// Recurso pmr que lleva la cuenta de los bytes reservados y no liberados
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t outstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+
 // ---------------------------------------------------------------------
 // Funciones auxiliares 
 // ---------------------------------------------------------------------
 
 void generateOrthonormalBasis(const Vector3D<NType>& normal, Vector3D<NType>& u, Vector3D<NType>& v) {
     Point3D<NType> arbitrary;
-    if (std::abs(normal.getX().getValue()) < 0.9f)
+    if (std::abs(rawValue(normal.getX())) < 0.9f)
         arbitrary = Point3D<NType>(NType(1), NType(0), NType(0));
     else
         arbitrary = Point3D<NType>(NType(0), NType(1), NType(0));
@@ -84,18 +121,19 @@ bool similarPlane(const Plane<NType>& p1, const Plane<NType>& p2, float tol = 1e
     Vector3D<NType> n1 = p1.getNormal();
     Vector3D<NType> n2 = p2.getNormal();
     
+    // Tolerancia explícita (la misma que aplica Safe<T>) para que funcione con float/double
     NType dot = n1.dot(n2);
-    if (!(dot >= NType(1.0f) || dot <= NType(-1.0f)))
+    if (!(dot >= NType(1.0f - 1e-6f) || dot <= NType(-1.0f + 1e-6f)))
         return false;
     
-    if (dot <= NType(-1.0f)) {
+    if (dot <= NType(-1.0f + 1e-6f)) {
         n2 = -n2;
     }
     
     NType d1 = -(n1.dot(p1.getPoint()));
     NType d2 = -(n2.dot(p2.getPoint()));
     
-    return std::abs(d1.getValue() - d2.getValue()) < tol;
+    return std::abs(rawValue(d1) - rawValue(d2)) < tol;
 }
 
 
@@ -141,14 +179,14 @@ bool sweptSphereIntersectsPolygon(const Ball<NType>& ball, const LineSegment<NTy
 bool comparePolygonSets(const std::vector<Polygon<NType>>& a, const std::vector<Polygon<NType>>& b, float tol = 1e-3f) {
     auto findMatch = [&](const Polygon<NType>& poly) -> bool {
         for (const auto& cand : b) {
-            if (std::abs(poly.area().getValue() - cand.area().getValue()) < tol &&
+            if (std::abs(rawValue(poly.area()) - rawValue(cand.area())) < tol &&
                 ([](const Plane<NType>& p1, const Plane<NType>& p2, float tol2 = 1e-3f) -> bool {
                     Vector3D<NType> n1 = p1.getNormal(), n2 = p2.getNormal();
                     NType dot = n1.dot(n2);
                     if (!(dot >= NType(0.999f) || dot <= NType(-0.999f)))
                         return false;
                     Point3D<NType> pt1 = p1.getPoint(), pt2 = p2.getPoint();
-                    return pt1.distance(pt2).getValue() < tol2;
+                    return rawValue(pt1.distance(pt2)) < tol2;
                 })(poly.getPlane(), cand.getPlane()))
             {
                 return true;
@@ -159,7 +197,7 @@ bool comparePolygonSets(const std::vector<Polygon<NType>>& a, const std::vector<
 
     for (const auto& poly : a) {
         if (!findMatch(poly)) {
-            std::cerr << "No match found for polygon with area " << poly.area().getValue() << "\n";
+            std::cerr << "No match found for polygon with area " << rawValue(poly.area()) << "\n";
             return false;
         }
     }
@@ -174,10 +212,10 @@ bool checkSubtreeValidity(const BSPNode<NType>* node, const Plane<NType>& parent
         for (const auto& v : vertices) {
             NType d = parentPlane.distance(v);
             if (isFront) {
-                if (d.getValue() < -0.1f)
+                if (rawValue(d) < -0.1f)
                     return false;
             } else {
-                if (d.getValue() > 0.1f)
+                if (rawValue(d) > 0.1f)
                     return false;
             }
         }
@@ -186,6 +224,21 @@ bool checkSubtreeValidity(const BSPNode<NType>* node, const Plane<NType>& parent
 }
 
 
+// Caras de un cubo [x0, x0 + s] x [y0, y0 + s] x [z0, z0 + s] con normales hacia fuera
+std::vector<Polygon<NType>> cubeMesh(float x0, float y0, float z0, float s) {
+    auto p = [&](float dx, float dy, float dz) {
+        return Point3D<NType>(NType(x0 + dx * s), NType(y0 + dy * s), NType(z0 + dz * s));
+    };
+    return {
+        Polygon<NType>({p(0, 0, 0), p(0, 0, 1), p(0, 1, 1), p(0, 1, 0)}),  // -x
+        Polygon<NType>({p(1, 0, 0), p(1, 1, 0), p(1, 1, 1), p(1, 0, 1)}),  // +x
+        Polygon<NType>({p(0, 0, 0), p(1, 0, 0), p(1, 0, 1), p(0, 0, 1)}),  // -y
+        Polygon<NType>({p(0, 1, 0), p(0, 1, 1), p(1, 1, 1), p(1, 1, 0)}),  // +y
+        Polygon<NType>({p(0, 0, 0), p(0, 1, 0), p(1, 1, 0), p(1, 0, 0)}),  // -z
+        Polygon<NType>({p(0, 0, 1), p(1, 0, 1), p(1, 1, 1), p(0, 1, 1)}),  // +z
+    };
+}
+
 
 // ---------------------------------------------------------------------
 // Test 1: Verificar insercion
@@ -213,16 +266,16 @@ void testPolygonsIntegrity() {
     float  totalOriginalArea = 0.0f;
     float totalCandidateArea = 0.0f;
     for (const auto& orig : originalPolys) {
-        totalOriginalArea += orig.area().getValue();
+        totalOriginalArea += rawValue(orig.area());
         
         float sumCandidateArea = 0.0f;
         // Buscar los que estan en el mismo plano
         for (const auto& cand : candidatePolys) {
             if (similarPlane(orig.getPlane(), cand.getPlane())) {
-                sumCandidateArea += cand.area().getValue();
+                sumCandidateArea += rawValue(cand.area());
             }
         }
-        float diff = std::abs(sumCandidateArea - orig.area().getValue());
+        float diff = std::abs(sumCandidateArea - rawValue(orig.area()));
         assert(diff < 1e-1f);
         totalCandidateArea += sumCandidateArea;
     }
@@ -268,7 +321,7 @@ void testQueryRandomBalls(int iterations = 40) {
         
         // Ordenar
         auto sortByArea = [](const Polygon<>& a, const Polygon<>& b) {
-            return a.area().getValue() < b.area().getValue();
+            return rawValue(a.area()) < rawValue(b.area());
         };
         std::sort(bruteCandidates.begin(), bruteCandidates.end(), sortByArea);
         std::sort(queryCandidates.begin(), queryCandidates.end(), sortByArea);
@@ -339,11 +392,407 @@ void testTreeStructureValidity() {
 }
 
 
+// ---------------------------------------------------------------------
+// Test 4: Point3D empaquetado (float/double) vs Point3D<Safe<float>>
+// ---------------------------------------------------------------------
+void testPackedPointConsistency() {
+    std::cout << "Iniciando test de Point3D empaquetado...\n";
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    auto close = [](float a, float b) { return std::abs(a - b) <= 1e-3f * std::max(1.0f, std::abs(a)); };
+
+    for (int i = 0; i < 200; ++i) {
+        float ax = dist(gen), ay = dist(gen), az = dist(gen);
+        float bx = dist(gen), by = dist(gen), bz = dist(gen);
+        Point3D<NType> sa{NType(ax), NType(ay), NType(az)}, sb{NType(bx), NType(by), NType(bz)};
+        Point3D<float>  fa(ax, ay, az), fb(bx, by, bz);
+        Point3D<double> da(ax, ay, az), db(bx, by, bz);
+
+        Point3D<NType> sc = sa.cross(sb);
+        Point3D<float>  fc = fa.cross(fb);
+        Point3D<double> dc = da.cross(db);
+        assert(close(rawValue(sc.getX()), fc.getX()) && close(rawValue(sc.getY()), fc.getY()) &&
+               close(rawValue(sc.getZ()), fc.getZ()));
+        assert(close(fc.getZ(), static_cast<float>(dc.getZ())));
+        assert(close(rawValue(sa.dot(sb)), fa.dot(fb)));
+        assert(close(rawValue(sa.dot(sb)), static_cast<float>(da.dot(db))));
+        assert(close(rawValue((sa - sb).getY()), (fa - fb).getY()));
+        assert(close(rawValue((sa + sb).getZ()), static_cast<float>((da + db).getZ())));
+        assert(close(rawValue(sa.normalized().getX()), fa.normalized().getX()));
+        assert(close(rawValue(sa.normalized().getX()), static_cast<float>(da.normalized().getX())));
+    }
+
+    // Line.h, Plane.h y BSPTree.h funcionan sin cambios con el tipo empaquetado
+    BSPTree<float> tree;
+    tree.insert(Polygon<float>({Point3D<float>(0, 0, 0), Point3D<float>(10, 0, 0), Point3D<float>(0, 10, 0)}));
+    tree.insert(Polygon<float>({Point3D<float>(0, 0, 5), Point3D<float>(10, 0, 5), Point3D<float>(0, 10, 5)}));
+    Ball<float> ball(Point3D<float>(1, 1, -1), Vector3D<float>(0, 0, 1), 0.5f);
+    LineSegment<float> movement = ball.step(2.0f);
+    assert(tree.query(ball, movement).size() == 1);
+
+    std::cout << "Test de Point3D empaquetado pasó exitosamente.\n";
+}
+
+
+// ---------------------------------------------------------------------
+// Test 5: Plantillas de expresión de Point3D genérico
+// ---------------------------------------------------------------------
+void testPointExpressions() {
+    std::cout << "Iniciando test de expresiones de Point3D...\n";
+
+    using P = Point3D<NType>;
+    P a{NType(1.0f), NType(2.0f), NType(3.0f)}, b{NType(-4.0f), NType(0.5f), NType(2.0f)};
+    NType t(0.25f);
+
+    // Misma aritmética que evaluando paso a paso
+    P fused = a + (b - a) * t;
+    P ab = b - a;
+    ab *= t;
+    P stepwise = a;
+    stepwise += ab;
+    assert(fused == stepwise);
+    assert(a.lerp(b, t) == a * (NType(1.0f) - t) + b * t);
+
+    // Los temporales se guardan por valor: la expresión sigue siendo válida
+    auto e = a.cross(b) - P(NType(1.0f), NType(1.0f), NType(1.0f));
+    P c = a.cross(b);
+    assert(e.getX() == c.getX() - NType(1.0f) && e.getZ() == c.getZ() - NType(1.0f));
+
+    // Asignación con aliasing y conversión a Vector3D
+    P d = a;
+    d = b - d;
+    assert(d == b - a);
+    Vector3D<NType> dir = (b - a) / NType(2.0f);
+    assert(dir.getY() == NType(-0.75f));
+    assert((NType(2.0f) * dir).dot(a - a) == NType(0.0f));
+
+    bool threw = false;
+    try {
+        P z = a / NType(0.0f);
+        (void)z;
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw && "La división por cero debe detectarse al construir la expresión.");
+
+    std::cout << "Test de expresiones de Point3D pasó exitosamente.\n";
+}
+
+
+// ---------------------------------------------------------------------
+// Test 6: BSPTree sobre una arena (mismo resultado, memoria reutilizable)
+// ---------------------------------------------------------------------
+void testArenaTree() {
+    std::cout << "Iniciando test de BSPTree con arena...\n";
+
+    std::vector<Polygon<NType>> polys;
+    for (int i = 0; i < 60; ++i) polys.push_back(generateRandomPolygon(3, 5));
+
+    BSPTree<NType> heapTree;
+    for (const auto& poly : polys) heapTree.insert(poly);
+
+    BSPArena arena(1 << 16);
+    size_t reserved = 0;
+    for (int level = 0; level < 3; ++level) {
+        BSPTree<NType> tree(&arena);
+        for (const auto& poly : polys) tree.insert(poly);
+
+        // Los polígonos guardados viven en la arena
+        const BSPNode<NType>* root = tree.getAllNodes().front();
+        assert(root->getPolygons().front().get_allocator().resource() == &arena);
+        assert(tree.getAllNodes().size() == heapTree.getAllNodes().size());
+        assert(tree.getAllPolygons() == heapTree.getAllPolygons());
+
+        tree.clear();
+        assert(arena.bytesUsed() > 0);
+        if (level == 0) reserved = arena.bytesReserved();
+        // Reconstruir el mismo nivel no pide más memoria
+        assert(arena.bytesReserved() == reserved);
+        arena.reset();
+    }
+
+    // Un recurso pmr que no es una arena recupera todo al vaciar o destruir el árbol
+    CountingResource counting;
+    {
+        BSPTree<NType> tree(&counting);
+        for (const auto& poly : polys) tree.insert(poly);
+        assert(counting.outstanding > 0);
+        tree.clear();
+        assert(counting.outstanding == 0 && "clear() debe liberar los nodos en un recurso no monotónico.");
+        for (const auto& poly : polys) tree.insert(poly);
+    }
+    assert(counting.outstanding == 0 && "El destructor debe liberar los nodos en un recurso no monotónico.");
+
+    // Sin recurso se usa el heap
+    BSPTree<NType> nullTree(nullptr);
+    for (const auto& poly : polys) nullTree.insert(poly);
+    assert(nullTree.getAllPolygons() == heapTree.getAllPolygons());
+
+    std::cout << "Test de BSPTree con arena pasó exitosamente.\n";
+}
+
+
+// ---------------------------------------------------------------------
+// Test 7: Estadísticas del árbol y de las consultas
+// ---------------------------------------------------------------------
+void testTreeStats() {
+    std::cout << "Iniciando test de estadísticas del BSPTree...\n";
+
+    BSPTree<NType> tree;
+    for (int i = 0; i < 50; ++i) tree.insert(generateRandomPolygon(3, 5));
+
+    BSPTreeHealth h = tree.health();
+    size_t histogramTotal = 0;
+    for (size_t count : h.depthHistogram) histogramTotal += count;
+    assert(h.nodeCount == tree.getAllNodes().size());
+    assert(histogramTotal == h.nodeCount && h.depthHistogram.size() == h.maxDepth);
+    assert(h.depthHistogram[0] == 1);
+    assert(h.insertedPolygons == 50 && h.storedPolygons == tree.getAllPolygons().size());
+    assert(h.fragmentRatio() >= 1.0);
+
+#if defined(BSP_ENABLE_STATS)
+    BSPQueryStats total;
+    tree.setQuerySampling(2);
+    for (int i = 0; i < 20; ++i) {
+        Ball<NType> ball = generateRandomBall();
+        LineSegment<NType> movement = ball.step(NType(1.0f));
+        auto found = tree.query(ball, movement, total);
+        assert(tree.query(ball, movement) == found);
+    }
+    assert(total.queries == 20 && total.results <= total.containsCalls);
+    assert(total.nodesVisited >= total.queries && total.planeTests >= 2 * total.nodesVisited);
+    assert(tree.sampledQueryStats().queries == 10);
+    std::cout << "  " << total << "\n";
+#endif
+    std::cout << "  " << h << "\n";
+    std::cout << "Test de estadísticas del BSPTree pasó exitosamente.\n";
+}
+
+
+// ---------------------------------------------------------------------
+// Test 8: BSP sólido (punto dentro y esfera contra sólido)
+// ---------------------------------------------------------------------
+void testSolidTree() {
+    std::cout << "Iniciando test de BSP sólido...\n";
+
+    // Dos cubos separados: [0,10]^3 y [20,30] x [0,10] x [0,10]
+    std::vector<Polygon<NType>> mesh = cubeMesh(0, 0, 0, 10);
+    std::vector<Polygon<NType>> second = cubeMesh(20, 0, 0, 10);
+    mesh.insert(mesh.end(), second.begin(), second.end());
+
+    std::mt19937 gen(7);
+    std::shuffle(mesh.begin(), mesh.end(), gen);
+    BSPTree<NType> tree;
+    tree.buildSolid(mesh);
+
+    auto insideBox = [](float x, float y, float z) {
+        bool inYZ = y > 0 && y < 10 && z > 0 && z < 10;
+        return inYZ && ((x > 0 && x < 10) || (x > 20 && x < 30));
+    };
+    std::uniform_real_distribution<float> coord(-5.0f, 35.0f);
+    for (int i = 0; i < 500; ++i) {
+        float x = coord(gen), y = coord(gen) / 2.0f, z = coord(gen) / 2.0f;
+        Point3D<NType> p{NType(x), NType(y), NType(z)};
+        assert(tree.isInside(p) == insideBox(x, y, z));
+    }
+
+    auto ball = [](float x, float y, float z, float r) {
+        return Ball<NType>(Point3D<NType>(NType(x), NType(y), NType(z)), Vector3D<NType>(), NType(r));
+    };
+    assert(tree.sphereIntersectsSolid(ball(5, 5, 5, 1)));      // dentro
+    assert(tree.sphereIntersectsSolid(ball(15, 5, 5, 6)));     // toca ambos cubos
+    assert(tree.sphereIntersectsSolid(ball(-1, 5, 5, 2)));     // cruza la cara -x
+    assert(!tree.sphereIntersectsSolid(ball(15, 5, 5, 4)));    // entre los cubos
+    assert(!tree.sphereIntersectsSolid(ball(5, 5, 20, 3)));    // encima
+
+    // La pila del recorrido se reutiliza: consultar de nuevo no reserva memoria
+    Ball<NType> probe = ball(15, 5, 5, 6);
+    size_t before = gHeapAllocations.load();
+    for (int i = 0; i < 100; ++i) assert(tree.sphereIntersectsSolid(probe));
+    assert(gHeapAllocations.load() == before && "sphereIntersectsSolid no debe reservar en el heap.");
+
+    std::cout << "Test de BSP sólido pasó exitosamente.\n";
+}
+
+// ---------------------------------------------------------------------
+// Test 9: PVS (celdas, portales y visibilidad entre hojas)
+// ---------------------------------------------------------------------
+void testVisibility() {
+    std::cout << "Iniciando test de PVS...\n";
+
+    // Sala A: [0,30]^3 hueca (normales hacia dentro) con una columna maciza
+    // [10,20] x [10,20] x [0,30] y dos postes finos contra las paredes que
+    // separan una hoja en cada esquina. Sala B: [40,50] x [0,10] x [0,10], separada.
+    auto inward = [](std::vector<Polygon<NType>> faces) {
+        for (auto& face : faces) {
+            std::vector<Point3D<NType>> v = face.getVertices();
+            std::reverse(v.begin(), v.end());
+            face = Polygon<NType>(v);
+        }
+        return faces;
+    };
+    std::vector<Polygon<NType>> mesh = inward(cubeMesh(0, 0, 0, 30));
+    // Columnas de sección [x, x + side] x [y, y + side] y altura 30
+    const float columns[3][3] = {{10, 10, 10}, {0, 9, 1}, {29, 20, 1}};
+    for (const auto& c : columns) {
+        for (auto& face : cubeMesh(c[0], c[1], 0, c[2])) {
+            std::vector<Point3D<NType>> v = face.getVertices();
+            for (auto& p : v) p = Point3D<NType>(p.getX(), p.getY(), NType(rawValue(p.getZ()) * 30.0f / c[2]));
+            mesh.emplace_back(v);
+        }
+    }
+    std::vector<Polygon<NType>> roomB = inward(cubeMesh(40, 0, 0, 10));
+    mesh.insert(mesh.end(), roomB.begin(), roomB.end());
+
+    BSPTree<NType> tree;
+    tree.buildSolid(mesh);
+    tree.computePVS(2);
+    const BSPVisibility<NType>* vis = tree.getVisibility();
+    assert(vis && vis->leafCount() >= 2);
+    assert(!vis->getPortals().empty());
+    assert(vis->compressedBytes() > 0);
+
+    auto inPillar = [&](float x, float y) {
+        for (const auto& c : columns)
+            if (x > c[0] && x < c[0] + c[2] && y > c[1] && y < c[1] + c[2]) return true;
+        return false;
+    };
+    // ¿El segmento a-b atraviesa alguna columna? (prueba de losas en x/y)
+    auto blocked = [&](const float* a, const float* b) {
+        for (const auto& c : columns) {
+            float t0 = 0.0f, t1 = 1.0f;
+            bool outside = false;
+            for (int axis = 0; axis < 2 && !outside; ++axis) {
+                float lo = c[axis], hi = c[axis] + c[2];
+                float d = b[axis] - a[axis];
+                if (std::fabs(d) < 1e-9f) {
+                    outside = a[axis] <= lo || a[axis] >= hi;
+                    continue;
+                }
+                float ta = (lo - a[axis]) / d, tb = (hi - a[axis]) / d;
+                if (ta > tb) std::swap(ta, tb);
+                t0 = std::max(t0, ta);
+                t1 = std::min(t1, tb);
+            }
+            if (!outside && t0 < t1) return true;
+        }
+        return false;
+    };
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> coordA(0.5f, 29.5f), coordB(40.5f, 49.5f), coordBYZ(0.5f, 9.5f);
+    auto point = [](const float* c) { return Point3D<NType>{NType(c[0]), NType(c[1]), NType(c[2])}; };
+    for (int i = 0; i < 300; ++i) {
+        float a[3] = {coordA(gen), coordA(gen), coordA(gen)};
+        float a2[3] = {coordA(gen), coordA(gen), coordA(gen)};
+        float b[3] = {coordB(gen), coordBYZ(gen), coordBYZ(gen)};
+        if (inPillar(a[0], a[1]) || inPillar(a2[0], a2[1])) continue;
+        std::vector<size_t> fromA = tree.visibleLeaves(point(a));
+        std::vector<size_t> fromB = tree.visibleLeaves(point(b));
+        assert(!fromA.empty() && !fromB.empty());
+        // Las salas no se ven entre sí
+        for (size_t leaf : fromB) assert(std::find(fromA.begin(), fromA.end(), leaf) == fromA.end());
+        // Conservador: si nada tapa el segmento, la hoja del otro extremo es visible
+        if (!blocked(a, a2)) {
+            size_t leafA2 = vis->leafOf(point(a2));
+            assert(leafA2 != BSPVisibility<NType>::kNoLeaf);
+            assert(std::find(fromA.begin(), fromA.end(), leafA2) != fromA.end());
+            assert(vis->isVisible(vis->leafOf(point(a)), leafA2));
+        }
+    }
+    // Dentro de la columna no hay hoja vacía
+    assert(tree.visibleLeaves(Point3D<NType>{NType(15), NType(15), NType(15)}).empty());
+
+    // Desde la esquina [0,1] x [0,9] la esquina [29,30] x [21,30] queda detrás
+    // de la columna: hay un camino de portales entre ambas, pero ninguna línea
+    // de visión. Cada portal del camino está delante del de salida, así que
+    // solo el recorte de portal a portal la descarta.
+    size_t corner = vis->leafOf(Point3D<NType>{NType(0.5f), NType(4.5f), NType(15)});
+    size_t hidden = vis->leafOf(Point3D<NType>{NType(29.5f), NType(25.5f), NType(15)});
+    assert(corner != BSPVisibility<NType>::kNoLeaf && hidden != BSPVisibility<NType>::kNoLeaf && corner != hidden);
+    std::vector<char> reached(vis->leafCount(), 0);
+    std::vector<size_t> pending{corner};
+    reached[corner] = 1;
+    while (!pending.empty()) {
+        size_t leaf = pending.back();
+        pending.pop_back();
+        for (const auto& portal : vis->getPortals()) {
+            size_t other = portal.front == leaf ? portal.back : portal.back == leaf ? portal.front : leaf;
+            if (reached[other]) continue;
+            reached[other] = 1;
+            pending.push_back(other);
+        }
+    }
+    assert(reached[hidden] && "La esquina oculta debe ser alcanzable por portales.");
+    assert(!vis->isVisible(corner, hidden) && !vis->isVisible(hidden, corner));
+
+    // Desde la sala B solo se ven las paredes de B
+    std::vector<Polygon<NType>> faces = tree.visiblePolygons(Point3D<NType>{NType(45), NType(5), NType(5)});
+    assert(!faces.empty());
+    for (const auto& face : faces) {
+        for (size_t k = 0; k < face.vertexCount(); ++k) assert(rawValue(face.getVertex(k).getX()) >= 40 - 1e-3);
+    }
+    std::cout << "Test de PVS pasó exitosamente.\n";
+}
+
+
+// ---------------------------------------------------------------------
+// Test 10: los cortes no reservan memoria una vez calentado el scratch
+// ---------------------------------------------------------------------
+void testSplitAllocations() {
+    std::cout << "Iniciando test de reservas durante los cortes...\n";
+
+    std::vector<Polygon<NType>> polys;
+    for (int i = 0; i < 80; ++i) polys.push_back(generateRandomPolygon(3, 5));
+
+    // Nodos y polígonos van a la arena; con el heap solo quedan los buffers de corte
+    BSPArena arena(1 << 16);
+    BSPTree<NType> tree(&arena);
+    for (const auto& poly : polys) tree.insert(poly);
+    size_t fragments = tree.getAllPolygons().size();
+    assert(fragments > polys.size() && "La escena de prueba debe producir cortes.");
+
+    for (int level = 0; level < 2; ++level) {
+        tree.clear();
+        arena.reset();
+        size_t before = gHeapAllocations.load();
+        for (const auto& poly : polys) tree.insert(poly);
+        size_t allocations = gHeapAllocations.load() - before;
+        assert(allocations == 0 && "Reconstruir tras calentar no debe reservar en el heap.");
+    }
+    assert(tree.getAllPolygons().size() == fragments);
+    tree.clear();
+
+    // BSPNode::insert(const Polygon&) reutiliza su scratch por hilo del mismo modo
+    for (int level = 0; level < 3; ++level) {
+        arena.reset();
+        BSPNode<NType> root(&arena);
+        size_t before = gHeapAllocations.load();
+        for (const auto& poly : polys) root.insert(poly);
+        size_t allocations = gHeapAllocations.load() - before;
+        assert((level == 0 || allocations == 0) && "BSPNode::insert no debe reservar en el heap tras calentar.");
+        std::vector<Polygon<NType>> nodePolys;
+        root.collectPolygons(nodePolys);
+        assert(nodePolys.size() == fragments);
+    }
+
+    std::cout << "Test de reservas durante los cortes pasó exitosamente.\n";
+}
+
+
 int main() {
     try {
         testTreeStructureValidity();
         testPolygonsIntegrity();
         testQueryRandomBalls();
+        testPackedPointConsistency();
+        testPointExpressions();
+        testArenaTree();
+        testTreeStats();
+        testSolidTree();
+        testVisibility();
+        testSplitAllocations();
 
         std::cout << "\nTodos los tests se ejecutaron correctamente.\n";
         return 0;
@@ -0,0 +1,121 @@
+// Microbenchmark de Point3D: versión genérica (Safe<T>) vs versión empaquetada (float/double).
+// Se compila dos veces (ver CMakeLists.txt): PointBench con SIMD y
+// PointBenchScalar con POINT3D_NO_SIMD. La columna "empaquetado" de ambos
+// aísla la ganancia de SIMD a igual representación; `point-bench` corre los dos.
+// Uso: PointBench [iteraciones]
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Point.h"
+#include "DataType.h"
+
+namespace {
+
+constexpr std::size_t kPoints = 4096;
+
+template <typename T>
+T toScalar(float v) { return T(v); }
+
+template <typename T>
+double toDouble(const T& v) { return static_cast<double>(v); }
+template <typename T>
+double toDouble(const Safe<T>& v) { return static_cast<double>(v.getValue()); }
+
+template <typename T>
+std::vector<Point3D<T>> makePoints(unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::vector<Point3D<T>> pts;
+    pts.reserve(kPoints);
+    for (std::size_t i = 0; i < kPoints; ++i)
+        pts.emplace_back(toScalar<T>(dist(gen)), toScalar<T>(dist(gen)), toScalar<T>(dist(gen)));
+    return pts;
+}
+
+// Ejecuta 'op' sobre todos los pares (a[i], b[i]) y devuelve ns por operación.
+// Los resultados se acumulan completos (las tres componentes) para que el
+// compilador no pueda descartar parte del trabajo.
+template <typename T, typename Op>
+double timeOp(const std::vector<Point3D<T>>& a, const std::vector<Point3D<T>>& b, int iterations, Op op) {
+    volatile double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        Point3D<T> acc;
+        for (std::size_t i = 0; i < a.size(); ++i)
+            acc += op(a[i], b[i]);
+        sink = sink + toDouble(acc.getX()) + toDouble(acc.getY()) + toDouble(acc.getZ());
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (static_cast<double>(iterations) * static_cast<double>(a.size()));
+}
+
+struct OpTimes {
+    double add, sub, dot, cross, normalize;
+};
+
+template <typename T>
+OpTimes runSuite(int iterations) {
+    auto a = makePoints<T>(1);
+    auto b = makePoints<T>(2);
+    OpTimes t{};
+    t.add = timeOp<T>(a, b, iterations, [](const Point3D<T>& p, const Point3D<T>& q) {
+        return p + q;
+    });
+    t.sub = timeOp<T>(a, b, iterations, [](const Point3D<T>& p, const Point3D<T>& q) {
+        return p - q;
+    });
+    t.dot = timeOp<T>(a, b, iterations, [](const Point3D<T>& p, const Point3D<T>& q) {
+        return q * p.dot(q);
+    });
+    t.cross = timeOp<T>(a, b, iterations, [](const Point3D<T>& p, const Point3D<T>& q) {
+        return p.cross(q);
+    });
+    t.normalize = timeOp<T>(a, b, iterations, [](const Point3D<T>& p, const Point3D<T>&) {
+        return p.normalized();
+    });
+    return t;
+}
+
+void printRow(const std::string& op, double generic, double packed) {
+    std::cout << std::left << std::setw(12) << op << std::right
+              << std::setw(12) << generic << std::setw(12) << packed
+              << std::setw(10) << (generic / packed) << "x\n";
+}
+
+void printSuite(const std::string& title, const OpTimes& generic, const OpTimes& packed) {
+    std::cout << "\n" << title << " (ns/op)\n";
+    std::cout << std::left << std::setw(12) << "op" << std::right
+              << std::setw(12) << "generico" << std::setw(12) << "empaquetado"
+              << std::setw(11) << "speedup\n";
+    printRow("add", generic.add, packed.add);
+    printRow("sub", generic.sub, packed.sub);
+    printRow("dot", generic.dot, packed.dot);
+    printRow("cross", generic.cross, packed.cross);
+    printRow("normalize", generic.normalize, packed.normalize);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (iterations <= 0) iterations = 1;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Point3D microbenchmark: " << kPoints << " puntos x " << iterations << " iteraciones\n";
+#if defined(POINT3D_AVX)
+    std::cout << "SIMD: SSE + AVX\n";
+#elif defined(POINT3D_SSE)
+    std::cout << "SIMD: SSE\n";
+#else
+    std::cout << "SIMD: ninguno (version escalar)\n";
+#endif
+
+    printSuite("float", runSuite<Safe<float>>(iterations), runSuite<float>(iterations));
+    printSuite("double", runSuite<Safe<double>>(iterations), runSuite<double>(iterations));
+    return 0;
+}
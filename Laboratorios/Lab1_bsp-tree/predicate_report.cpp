@@ -0,0 +1,189 @@
+// Reporte de fragmentación del BSPTree en entradas de estrés.
+// Se compila dos veces (ver CMakeLists.txt): con los predicados robustos y con
+// BSP_EPSILON_PREDICATES (tolerancia fija de 1e-3) para comparar ambos resultados.
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "BSPTree.h"
+#include "Plane.h"
+#include "Point.h"
+#include "DataType.h"
+
+namespace {
+
+using P = Point3D<NType>;
+
+P point(float x, float y, float z) { return P(NType(x), NType(y), NType(z)); }
+
+// Triángulos pequeños repartidos en una escena de tamaño 'extent'
+std::vector<Polygon<NType>> scatteredTriangles(int count, float extent, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> center(-extent, extent);
+    std::uniform_real_distribution<float> local(-20.0f, 20.0f);
+    std::vector<Polygon<NType>> polys;
+    while (static_cast<int>(polys.size()) < count) {
+        float cx = center(gen), cy = center(gen), cz = center(gen);
+        P a = point(cx + local(gen), cy + local(gen), cz + local(gen));
+        P b = point(cx + local(gen), cy + local(gen), cz + local(gen));
+        P c = point(cx + local(gen), cy + local(gen), cz + local(gen));
+        if ((b - a).cross(c - a).magnitude() < NType(1.0f)) continue;
+        polys.push_back(Polygon<NType>({a, b, c}));
+    }
+    return polys;
+}
+
+// Muros alineados a los ejes sobre una rejilla que cubre 'extent'
+std::vector<Polygon<NType>> gridWalls(int cells, float extent) {
+    std::vector<Polygon<NType>> polys;
+    const float size = std::round(extent / static_cast<float>(cells));
+    for (int i = 0; i < cells; ++i) {
+        for (int j = 0; j < cells; ++j) {
+            float x = size * static_cast<float>(i);
+            float y = size * static_cast<float>(j);
+            float z = 0.0f;
+            // Muro en el plano x = cte y muro en el plano y = cte
+            polys.push_back(Polygon<NType>({point(x, y, z), point(x, y + size, z),
+                                            point(x, y + size, z + size), point(x, y, z + size)}));
+            polys.push_back(Polygon<NType>({point(x, y, z), point(x, y, z + size),
+                                            point(x + size, y, z + size), point(x + size, y, z)}));
+        }
+    }
+    return polys;
+}
+
+// Capas de triángulos sobre planos inclinados con normal (1, 2, 3). Todos los
+// vértices son enteros, así que los triángulos de una misma capa son
+// exactamente coplanares aunque estén muy separados entre sí.
+std::vector<Polygon<NType>> latticeLayers(int layers, int perLayer, float extent, unsigned seed) {
+    std::mt19937 gen(seed);
+    int spread = std::max(1, static_cast<int>(extent / 5.0f));
+    std::uniform_int_distribution<int> coord(-spread, spread);
+    std::vector<Polygon<NType>> polys;
+    auto lattice = [&](int layer, int u, int v) {
+        // u * (2, -1, 0) + v * (3, 0, -1) + layer * (0, 0, 4)
+        return point(static_cast<float>(2 * u + 3 * v),
+                     static_cast<float>(-u),
+                     static_cast<float>(-v + 4 * layer));
+    };
+    for (int layer = 0; layer < layers; ++layer) {
+        for (int i = 0; i < perLayer; ++i) {
+            int u = coord(gen), v = coord(gen);
+            polys.push_back(Polygon<NType>({lattice(layer, u, v), lattice(layer, u + 2, v), lattice(layer, u, v + 2)}));
+        }
+    }
+    std::shuffle(polys.begin(), polys.end(), gen);
+    return polys;
+}
+
+// Terreno de triángulos que comparten aristas, con celdas de tamaño extent / cells
+std::vector<Polygon<NType>> terrainMesh(int cells, float extent, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> height(-3.0f, 3.0f);
+    std::vector<std::vector<float>> h(cells + 1, std::vector<float>(cells + 1));
+    for (auto& row : h)
+        for (auto& v : row) v = std::round(height(gen) * 8.0f) / 8.0f;
+    std::vector<Polygon<NType>> polys;
+    const float size = std::round(extent / static_cast<float>(cells));
+    auto at = [&](int i, int j) {
+        return point(size * static_cast<float>(i), size * static_cast<float>(j), h[i][j] * size / 4.0f);
+    };
+    for (int i = 0; i < cells; ++i) {
+        for (int j = 0; j < cells; ++j) {
+            polys.push_back(Polygon<NType>({at(i, j), at(i + 1, j), at(i + 1, j + 1)}));
+            polys.push_back(Polygon<NType>({at(i, j), at(i + 1, j + 1), at(i, j + 1)}));
+        }
+    }
+    return polys;
+}
+
+struct Report {
+    size_t input = 0;
+    size_t fragments = 0;
+    size_t slivers = 0;
+    size_t nodes = 0;
+    size_t depth = 0;
+    bool failed = false;
+};
+
+// Área calculada en double respecto al primer vértice (no pierde precisión lejos del origen)
+double robustArea(const Polygon<NType>& poly) {
+    auto v = poly.getVertices();
+    if (v.size() < 3) return 0.0;
+    auto d = [&](size_t i, int axis) {
+        const NType& a = axis == 0 ? v[i].getX() : axis == 1 ? v[i].getY() : v[i].getZ();
+        const NType& o = axis == 0 ? v[0].getX() : axis == 1 ? v[0].getY() : v[0].getZ();
+        return static_cast<double>(rawValue(a)) - static_cast<double>(rawValue(o));
+    };
+    double nx = 0.0, ny = 0.0, nz = 0.0;
+    for (size_t i = 1; i + 1 < v.size(); ++i) {
+        nx += d(i, 1) * d(i + 1, 2) - d(i, 2) * d(i + 1, 1);
+        ny += d(i, 2) * d(i + 1, 0) - d(i, 0) * d(i + 1, 2);
+        nz += d(i, 0) * d(i + 1, 1) - d(i, 1) * d(i + 1, 0);
+    }
+    return 0.5 * std::sqrt(nx * nx + ny * ny + nz * nz);
+}
+
+size_t depthOf(const BSPNode<NType>* node) {
+    if (!node) return 0;
+    return 1 + std::max(depthOf(node->getFront()), depthOf(node->getBack()));
+}
+
+Report buildAndMeasure(const std::vector<Polygon<NType>>& polys) {
+    Report r;
+    r.input = polys.size();
+    try {
+        BSPTree<NType> tree;
+        for (const auto& poly : polys) tree.insert(poly);
+        auto nodes = tree.getAllNodes();
+        auto frags = tree.getAllPolygons();
+        r.nodes = nodes.size();
+        r.depth = nodes.empty() ? 0 : depthOf(nodes.front());
+        r.fragments = frags.size();
+        for (const auto& f : frags) {
+            if (robustArea(f) < 1e-2) ++r.slivers;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "  [EXCEPCIÓN] " << e.what() << "\n";
+        r.failed = true;
+    }
+    return r;
+}
+
+void printRow(const std::string& name, const Report& r) {
+    std::cout << std::left << std::setw(30) << name << std::right
+              << std::setw(8) << r.input << std::setw(11) << r.fragments
+              << std::setw(9) << std::setprecision(3) << std::fixed
+              << (r.input ? static_cast<double>(r.fragments) / static_cast<double>(r.input) : 0.0)
+              << std::setw(9) << r.slivers << std::setw(8) << r.nodes << std::setw(7) << r.depth
+              << (r.failed ? "  (falló)" : "") << "\n";
+}
+
+} // namespace
+
+int main() {
+#if defined(BSP_EPSILON_PREDICATES)
+    std::cout << "Clasificación: tolerancia fija 1e-3\n";
+#else
+    std::cout << "Clasificación: predicados robustos (filtro + aritmética exacta)\n";
+#endif
+    std::cout << std::left << std::setw(30) << "entrada" << std::right
+              << std::setw(8) << "input" << std::setw(11) << "fragments"
+              << std::setw(9) << "ratio" << std::setw(9) << "slivers"
+              << std::setw(8) << "nodes" << std::setw(7) << "depth" << "\n";
+
+    // 'extent' es el tamaño de la escena: el error de la tolerancia fija crece
+    // con la distancia entre el punto clasificado y el punto del plano.
+    for (float extent : {1e2f, 1e4f, 1e5f}) {
+        std::string suffix = " @" + std::to_string(static_cast<long>(extent));
+        printRow("triangulos" + suffix, buildAndMeasure(scatteredTriangles(300, extent, 7)));
+        printRow("muros rejilla" + suffix, buildAndMeasure(gridWalls(12, extent)));
+        printRow("capas coplanares" + suffix, buildAndMeasure(latticeLayers(6, 40, extent, 5)));
+        printRow("terreno" + suffix, buildAndMeasure(terrainMesh(14, extent, 11)));
+    }
+    return 0;
+}
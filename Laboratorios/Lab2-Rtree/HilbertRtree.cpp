@@ -0,0 +1,277 @@
+#include "HilbertRtree.h"
+using namespace std;
+
+namespace {
+
+const uint32_t kHilbertSide = 1u << 16;  // celdas por eje
+
+// Distancia a lo largo de la curva de Hilbert de la celda (x, y)
+uint64_t hilbertIndex(uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = kHilbertSide / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += uint64_t(s) * s * ((3 * rx) ^ ry);
+        // Rotar el cuadrante para que la curva quede en orientacion base
+        if (ry == 0) {
+            if (rx == 1) {
+                x = kHilbertSide - 1 - x;
+                y = kHilbertSide - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+    return d;
+}
+
+uint32_t gridCoord(float v, float low, float high) {
+    if (!(high > low)) return 0;
+    float t = (v - low) / (high - low);
+    t = min(max(t, 0.0f), 1.0f);
+    return min<uint32_t>(kHilbertSide - 1, static_cast<uint32_t>(t * kHilbertSide));
+}
+
+} // namespace
+
+//---------------------- HilbertNode --------------------
+
+void HilbertNode::refresh() {
+    if (isLeaf) {
+        if (entries.empty()) {
+            mbr = MBB();
+            lhv = 0;
+            return;
+        }
+        mbr = MBB(entries[0].pt, entries[0].pt);
+        for (const HilbertEntry &e : entries) mbr.expandToInclude(e.pt);
+        lhv = entries.back().key;
+    } else {
+        mbr = MBB::computeFromNodes(children);
+        lhv = children.back()->lhv;
+    }
+}
+
+//---------------------- HilbertRTree --------------------
+
+HilbertRTree::HilbertRTree(const MBB &world, size_t maxEntries)
+    : root(new HilbertNode()), maxEntries(maxEntries), world(world) {
+    assert(maxEntries >= 2);
+}
+
+HilbertRTree::~HilbertRTree() {
+    destroy(root);
+}
+
+void HilbertRTree::destroy(HilbertNode* node) {
+    for (HilbertNode* child : node->children) destroy(child);
+    delete node;
+}
+
+void HilbertRTree::clear() {
+    destroy(root);
+    root = new HilbertNode();
+    size_ = 0;
+    nextId = 0;
+}
+
+uint64_t HilbertRTree::hilbertKey(const Point &p) const {
+    return hilbertIndex(gridCoord(p.x, world.lower.x, world.upper.x), gridCoord(p.y, world.lower.y, world.upper.y));
+}
+
+EntryId HilbertRTree::insert(const Point &p) {
+    EntryId id = nextId++;
+    insert(p, id);
+    return id;
+}
+
+void HilbertRTree::insert(const Point &p, EntryId id) {
+    const uint64_t key = hilbertKey(p);
+
+    // Bajar por el primer hijo con LHV >= clave (o el ultimo)
+    vector<HilbertNode*> path{root};
+    while (!path.back()->isLeaf) {
+        const vector<HilbertNode*> &children = path.back()->children;
+        auto it = lower_bound(children.begin(), children.end(), key,
+                              [](const HilbertNode* n, uint64_t k) { return n->lhv < k; });
+        path.push_back(it == children.end() ? children.back() : *it);
+    }
+    vector<HilbertEntry> &entries = path.back()->entries;
+    auto pos = upper_bound(entries.begin(), entries.end(), key,
+                           [](uint64_t k, const HilbertEntry &e) { return k < e.key; });
+    entries.insert(pos, { p, id, key });
+    ++size_;
+    if (id >= nextId) nextId = id + 1;
+
+    // Subir tratando desbordes y ajustando MBB y LHV
+    for (size_t i = path.size(); i-- > 1;) {
+        if (path[i]->count() > maxEntries) handleOverflow(path[i - 1], path[i]);
+        else path[i]->refresh();
+    }
+    if (root->count() > maxEntries) {
+        // La raiz no tiene hermanos: pasa su contenido a dos hijos nuevos
+        HilbertNode* first = new HilbertNode();
+        HilbertNode* second = new HilbertNode();
+        first->isLeaf = second->isLeaf = root->isLeaf;
+        first->entries.swap(root->entries);
+        first->children.swap(root->children);
+        root->isLeaf = false;
+        root->children = { first, second };
+        redistribute(root->children);
+    }
+    root->refresh();
+}
+
+void HilbertRTree::handleOverflow(HilbertNode* parent, HilbertNode* node) {
+    vector<HilbertNode*> &siblings = parent->children;
+    size_t idx = find(siblings.begin(), siblings.end(), node) - siblings.begin();
+    HilbertNode* extra = nullptr;
+    if (siblings.size() == 1) {
+        // Sin hermano con quien cooperar: split 1 a 2
+        extra = new HilbertNode();
+        extra->isLeaf = node->isLeaf;
+        siblings.push_back(extra);
+        redistribute({ node, extra });
+        return;
+    }
+    // Hermano cooperante: el siguiente, o el anterior si es el ultimo
+    size_t first = idx + 1 < siblings.size() ? idx : idx - 1;
+    HilbertNode* a = siblings[first];
+    HilbertNode* b = siblings[first + 1];
+    if (a->count() + b->count() <= 2 * maxEntries) {
+        redistribute({ a, b });
+        return;
+    }
+    // Los dos estan llenos: split 2 a 3
+    extra = new HilbertNode();
+    extra->isLeaf = node->isLeaf;
+    siblings.insert(siblings.begin() + first + 2, extra);
+    redistribute({ a, b, extra });
+}
+
+void HilbertRTree::redistribute(const vector<HilbertNode*> &nodes) {
+    const size_t parts = nodes.size();
+    if (nodes[0]->isLeaf) {
+        vector<HilbertEntry> all;
+        for (HilbertNode* n : nodes) all.insert(all.end(), n->entries.begin(), n->entries.end());
+        for (size_t k = 0; k < parts; ++k) {
+            nodes[k]->entries.assign(all.begin() + all.size() * k / parts, all.begin() + all.size() * (k + 1) / parts);
+            nodes[k]->refresh();
+        }
+    } else {
+        vector<HilbertNode*> all;
+        for (HilbertNode* n : nodes) all.insert(all.end(), n->children.begin(), n->children.end());
+        for (size_t k = 0; k < parts; ++k) {
+            nodes[k]->children.assign(all.begin() + all.size() * k / parts, all.begin() + all.size() * (k + 1) / parts);
+            nodes[k]->refresh();
+        }
+    }
+}
+
+void HilbertRTree::bulkLoad(vector<Point> points, float fill) {
+    clear();
+    vector<HilbertEntry> entries(points.size());
+    for (size_t i = 0; i < points.size(); ++i) entries[i] = { points[i], i, hilbertKey(points[i]) };
+    stable_sort(entries.begin(), entries.end(),
+                [](const HilbertEntry &a, const HilbertEntry &b) { return a.key < b.key; });
+    size_ = entries.size();
+    nextId = entries.size();
+    if (entries.empty()) return;
+
+    // Grupos de tamano parecido, con a lo sumo maxEntries cada uno
+    const size_t target = max<size_t>(1, min(maxEntries, static_cast<size_t>(fill * maxEntries)));
+    auto groupCount = [&](size_t n) { return max((n + target - 1) / target, (n + maxEntries - 1) / maxEntries); };
+
+    vector<HilbertNode*> level;
+    size_t groups = groupCount(entries.size());
+    for (size_t g = 0; g < groups; ++g) {
+        HilbertNode* leaf = new HilbertNode();
+        leaf->entries.assign(entries.begin() + entries.size() * g / groups, entries.begin() + entries.size() * (g + 1) / groups);
+        leaf->refresh();
+        level.push_back(leaf);
+    }
+    while (level.size() > maxEntries) {
+        groups = groupCount(level.size());
+        vector<HilbertNode*> parents;
+        for (size_t g = 0; g < groups; ++g) {
+            HilbertNode* parent = new HilbertNode();
+            parent->isLeaf = false;
+            parent->children.assign(level.begin() + level.size() * g / groups, level.begin() + level.size() * (g + 1) / groups);
+            parent->refresh();
+            parents.push_back(parent);
+        }
+        level.swap(parents);
+    }
+
+    if (level.size() == 1) {
+        delete root;
+        root = level[0];
+    } else {
+        root->isLeaf = false;
+        root->children = level;
+        root->refresh();
+    }
+}
+
+vector<Point> HilbertRTree::search(const MBB &query) const {
+    vector<Point> result;
+    search(query, result);
+    return result;
+}
+
+void HilbertRTree::search(const MBB &query, vector<Point> &out, SearchStats* stats) const {
+    if (root->count() == 0) return;
+    // Pila de (nodo, contenido en la consulta)
+    vector<pair<const HilbertNode*, bool>> stack;
+    if (root->mbr.overlaps(query)) stack.push_back({ root, query.contains(root->mbr) });
+    else if (stats) ++stats->nodesPruned;
+    while (!stack.empty()) {
+        const HilbertNode* node = stack.back().first;
+        bool contained = stack.back().second;
+        stack.pop_back();
+        if (stats) ++stats->nodesVisited;
+        if (node->isLeaf) {
+            for (const HilbertEntry &e : node->entries)
+                if (contained || query.contains(e.pt)) out.push_back(e.pt);
+            continue;
+        }
+        for (const HilbertNode* child : node->children) {
+            if (!contained && !child->mbr.overlaps(query)) {
+                if (stats) ++stats->nodesPruned;
+                continue;
+            }
+            bool inside = contained || query.contains(child->mbr);
+            if (stats && inside && !contained) ++stats->nodesContained;
+            stack.push_back({ child, inside });
+        }
+    }
+}
+
+vector<Point> HilbertRTree::kNN(const Point &query, size_t k) const {
+    auto expand = [&](const HilbertNode* node, auto &offer, auto &push) {
+        if (node->isLeaf) {
+            for (const HilbertEntry &e : node->entries) offer(e.pt.distanceSquaredTo(query), e.pt);
+        } else {
+            for (const HilbertNode* child : node->children) push(child->mbr.distanceSquaredTo(query), child);
+        }
+    };
+    const HilbertNode* start = root;
+    return bestFirstKNN<Point>(start, root->mbr.distanceSquaredTo(query), k, size_, numeric_limits<float>::infinity(), expand);
+}
+
+size_t HilbertRTree::height() const {
+    size_t h = 1;
+    for (const HilbertNode* node = root; !node->isLeaf; node = node->children[0]) ++h;
+    return h;
+}
+
+double HilbertRTree::leafUtilization() const {
+    size_t leaves = 0;
+    vector<const HilbertNode*> stack{root};
+    while (!stack.empty()) {
+        const HilbertNode* node = stack.back();
+        stack.pop_back();
+        if (node->isLeaf) ++leaves;
+        else stack.insert(stack.end(), node->children.begin(), node->children.end());
+    }
+    return static_cast<double>(size_) / static_cast<double>(leaves * maxEntries);
+}
@@ -0,0 +1,78 @@
+// Hilbert R-tree (Kamel y Faloutsos): cada punto se ordena por el valor de
+// Hilbert de su posicion dentro de un espacio 'world' fijo. Las hojas guardan
+// los puntos ordenados por clave y los nodos internos a sus hijos ordenados
+// por LHV (mayor valor de Hilbert del subarbol), asi que el arbol es un B+-tree
+// sobre las claves con MBBs para las consultas.
+//
+// Insercion: se baja por el primer hijo con LHV >= clave. Un nodo que desborda
+// reparte sus entradas con un hermano vecino (split diferido 2 a 3): si entre
+// los dos caben, se reparten entre ellos; si no, se crea un tercer nodo y las
+// entradas de los dos se reparten en tres. Las hojas quedan llenas en ~2/3 o
+// mas aun con inserciones incrementales.
+#ifndef HILBERT_RTREE_H
+#define HILBERT_RTREE_H
+
+#include "Rtree.h"
+
+struct HilbertEntry {
+    Point pt;
+    EntryId id;
+    uint64_t key;  // valor de Hilbert de pt
+};
+
+struct HilbertNode {
+    bool isLeaf = true;
+    MBB mbr;
+    uint64_t lhv = 0;                    // mayor clave del subarbol
+    std::vector<HilbertEntry> entries;   // hojas, ordenadas por clave
+    std::vector<HilbertNode*> children;  // nodos internos, ordenados por lhv
+
+    size_t count() const { return isLeaf ? entries.size() : children.size(); }
+    // Recalcula mbr y lhv a partir de las entradas
+    void refresh();
+};
+
+class HilbertRTree {
+public:
+    HilbertNode* root;
+    size_t maxEntries;
+
+    // 'world' acota las coordenadas usadas para las claves; los puntos fuera de
+    // el se insertan igual, con la clave del borde mas cercano
+    explicit HilbertRTree(const MBB &world, size_t maxEntries = 11);
+    ~HilbertRTree();
+
+    HilbertRTree(const HilbertRTree &) = delete;
+    HilbertRTree &operator=(const HilbertRTree &) = delete;
+
+    EntryId insert(const Point &p);
+    void insert(const Point &p, EntryId id);
+    // Carga masiva: ordena por clave y llena cada nodo con fill * maxEntries entradas
+    void bulkLoad(std::vector<Point> points, float fill = 1.0f);
+    void clear();
+
+    std::vector<Point> search(const MBB &query) const;
+    void search(const MBB &query, std::vector<Point> &out, SearchStats* stats = nullptr) const;
+    std::vector<Point> kNN(const Point &query, size_t k) const;
+
+    // Valor de Hilbert (orden 16 por eje) de p dentro de 'world'
+    uint64_t hilbertKey(const Point &p) const;
+
+    size_t size() const { return size_; }
+    size_t height() const;
+    // Puntos / (hojas * maxEntries)
+    double leafUtilization() const;
+
+private:
+    MBB world;
+    size_t size_ = 0;
+    EntryId nextId = 0;
+
+    // Reparte un nodo desbordado de 'parent' con un hermano (2 a 3)
+    void handleOverflow(HilbertNode* parent, HilbertNode* node);
+    // Reparte en orden las entradas de nodes (hermanos consecutivos) en partes iguales
+    static void redistribute(const std::vector<HilbertNode*> &nodes);
+    static void destroy(HilbertNode* node);
+};
+
+#endif // HILBERT_RTREE_H
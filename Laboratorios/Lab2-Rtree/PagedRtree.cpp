@@ -0,0 +1,356 @@
+#include "PagedRtree.h"
+#include <cstring>
+using namespace std;
+
+//---------------------- PageFile --------------------
+
+PageFile::PageFile(const string &path, size_t pageSize, OpenMode mode) : pageSize_(pageSize) {
+    ios::openmode flags = ios::in | ios::out | ios::binary;
+    if (mode == CREATE_NEW) flags |= ios::trunc;
+    file_.open(path, flags);
+    if (!file_.is_open()) throw runtime_error("PageFile: no se pudo abrir " + path);
+}
+
+void PageFile::read(PageId id, char* out) {
+    file_.seekg(static_cast<streamoff>(id) * static_cast<streamoff>(pageSize_));
+    file_.read(out, static_cast<streamsize>(pageSize_));
+    if (file_.gcount() != static_cast<streamsize>(pageSize_)) {
+        file_.clear();
+        throw runtime_error("PageFile: pagina " + to_string(id) + " incompleta");
+    }
+}
+
+void PageFile::write(PageId id, const char* data) {
+    file_.seekp(static_cast<streamoff>(id) * static_cast<streamoff>(pageSize_));
+    file_.write(data, static_cast<streamsize>(pageSize_));
+    if (!file_) throw runtime_error("PageFile: no se pudo escribir la pagina " + to_string(id));
+}
+
+//---------------------- BufferPool --------------------
+
+BufferPool::BufferPool(PageFile &file, size_t frames) : file_(file), frames_(frames) {
+    assert(frames > 0);
+    data_ = static_cast<char*>(::operator new(frames * file_.pageSize(), align_val_t(64)));
+}
+
+BufferPool::~BufferPool() {
+    ::operator delete(data_, align_val_t(64));
+}
+
+size_t BufferPool::claimFrame(PageId id) {
+    size_t victim = frames_.size();
+    for (size_t f = 0; f < frames_.size() && victim == frames_.size(); ++f) {
+        if (frames_[f].page == kFreeFrame) victim = f;
+    }
+    // CLOCK: dos vueltas alcanzan para limpiar los bits de referencia
+    for (size_t step = 0; step < 2 * frames_.size() && victim == frames_.size(); ++step) {
+        Frame &frame = frames_[hand_];
+        size_t current = hand_;
+        hand_ = (hand_ + 1) % frames_.size();
+        if (frame.pins > 0) continue;
+        if (frame.referenced) {
+            frame.referenced = false;
+            continue;
+        }
+        victim = current;
+    }
+    if (victim == frames_.size()) throw runtime_error("BufferPool: todas las paginas estan fijadas");
+
+    Frame &frame = frames_[victim];
+    if (frame.page != kFreeFrame) {
+        if (frame.dirty) {
+            file_.write(frame.page, frameData(victim));
+            ++stats_.pageWrites;
+        }
+        table_.erase(frame.page);
+    }
+    frame.page = id;
+    frame.pins = 1;
+    frame.dirty = false;
+    frame.referenced = true;
+    table_[id] = victim;
+    return victim;
+}
+
+char* BufferPool::pin(PageId id) {
+    ++stats_.pageRequests;
+    auto it = table_.find(id);
+    if (it != table_.end()) {
+        Frame &frame = frames_[it->second];
+        ++frame.pins;
+        frame.referenced = true;
+        ++stats_.bufferHits;
+        return frameData(it->second);
+    }
+    size_t f = claimFrame(id);
+    try {
+        file_.read(id, frameData(f));
+    } catch (...) {
+        table_.erase(id);
+        frames_[f] = Frame();
+        throw;
+    }
+    ++stats_.pageReads;
+    return frameData(f);
+}
+
+char* BufferPool::pinNew(PageId id) {
+    assert(!table_.count(id));
+    size_t f = claimFrame(id);
+    memset(frameData(f), 0, file_.pageSize());
+    frames_[f].dirty = true;
+    return frameData(f);
+}
+
+void BufferPool::unpin(PageId id, bool dirty) {
+    Frame &frame = frames_[table_.at(id)];
+    assert(frame.pins > 0);
+    --frame.pins;
+    frame.dirty = frame.dirty || dirty;
+}
+
+void BufferPool::flush() {
+    for (size_t f = 0; f < frames_.size(); ++f) {
+        Frame &frame = frames_[f];
+        if (frame.page == kFreeFrame || !frame.dirty) continue;
+        file_.write(frame.page, frameData(f));
+        ++stats_.pageWrites;
+        frame.dirty = false;
+    }
+    file_.flush();
+}
+
+//---------------------- Formato de pagina --------------------
+namespace {
+
+const uint32_t kMagic = 0x32505452;  // "RTP2": ids de 64 bits
+
+struct MetaPage {
+    uint32_t magic;
+    uint32_t pageSize;
+    uint32_t root;
+    uint32_t height;
+    uint64_t pageCount;
+    uint64_t size;
+};
+
+struct NodeHeader {
+    uint32_t isLeaf;
+    uint32_t count;
+    MBB mbr;
+};
+
+struct LeafSlot {
+    Point pt;
+    EntryId id;
+};
+
+struct BranchSlot {
+    MBB mbr;
+    PageId child;
+};
+
+const NodeHeader &header(const char* page) { return *reinterpret_cast<const NodeHeader*>(page); }
+NodeHeader &header(char* page) { return *reinterpret_cast<NodeHeader*>(page); }
+
+template <typename Slot>
+const Slot* slots(const char* page) { return reinterpret_cast<const Slot*>(page + sizeof(NodeHeader)); }
+template <typename Slot>
+Slot* slots(char* page) { return reinterpret_cast<Slot*>(page + sizeof(NodeHeader)); }
+
+MBB boundsOf(const LeafSlot &s) { return MBB(s.pt, s.pt); }
+MBB boundsOf(const BranchSlot &s) { return s.mbr; }
+
+// Escribe 'entries' en la pagina y recalcula su MBB
+template <typename Slot>
+void storeEntries(char* page, bool leaf, const vector<Slot> &entries) {
+    NodeHeader &h = header(page);
+    h.isLeaf = leaf;
+    h.count = static_cast<uint32_t>(entries.size());
+    h.mbr = boundsOf(entries[0]);
+    for (const Slot &s : entries) h.mbr.expandToInclude(boundsOf(s));
+    copy(entries.begin(), entries.end(), slots<Slot>(page));
+}
+
+// Validado antes de abrir (y quizas truncar) el archivo
+size_t checkedPageSize(size_t pageSize) {
+    if (pageSize < 256 || pageSize % 64 != 0)
+        throw invalid_argument("PagedRTree: el tamano de pagina debe ser multiplo de 64 y >= 256");
+    return pageSize;
+}
+
+} // namespace
+
+//---------------------- PagedRTree --------------------
+
+PagedRTree::PagedRTree(const string &path, size_t pageSize, size_t poolPages, OpenMode mode)
+    : file_(path, checkedPageSize(pageSize), mode), pool_(file_, poolPages) {
+    maxEntries_ = (pageSize - sizeof(NodeHeader)) / max(sizeof(LeafSlot), sizeof(BranchSlot));
+
+    if (mode == CREATE_NEW) {
+        vector<char> blank(pageSize, 0);
+        file_.write(0, blank.data());
+        writeMeta();
+        return;
+    }
+    PageRef meta(pool_, 0);
+    const MetaPage &m = *reinterpret_cast<const MetaPage*>(meta.data());
+    if (m.magic != kMagic || m.pageSize != pageSize)
+        throw runtime_error("PagedRTree: " + path + " no es un arbol con paginas de " + to_string(pageSize) + " bytes");
+    root_ = m.root;
+    height_ = m.height;
+    pageCount_ = m.pageCount;
+    size_ = m.size;
+}
+
+PagedRTree::~PagedRTree() {
+    try {
+        flush();
+    } catch (const exception &e) {
+        cerr << "PagedRTree: " << e.what() << endl;
+    }
+}
+
+void PagedRTree::writeMeta() {
+    PageRef meta(pool_, 0);
+    MetaPage &m = *reinterpret_cast<MetaPage*>(meta.mutableData());
+    m.magic = kMagic;
+    m.pageSize = static_cast<uint32_t>(file_.pageSize());
+    m.root = root_;
+    m.height = static_cast<uint32_t>(height_);
+    m.pageCount = pageCount_;
+    m.size = size_;
+}
+
+void PagedRTree::flush() {
+    writeMeta();
+    pool_.flush();
+}
+
+PageId PagedRTree::insertAt(PageId id, const Point &p, EntryId pointId, MBB &bounds, MBB &siblingBounds) {
+    PageRef page(pool_, id);
+    char* data = page.mutableData();
+    NodeHeader &h = header(data);
+
+    if (h.isLeaf) {
+        if (h.count < maxEntries_) {
+            slots<LeafSlot>(data)[h.count++] = { p, pointId };
+            if (h.count == 1) h.mbr = MBB(p, p);
+            else h.mbr.expandToInclude(p);
+            bounds = h.mbr;
+            return kNoPage;
+        }
+        vector<LeafSlot> entries(slots<LeafSlot>(data), slots<LeafSlot>(data) + h.count);
+        entries.push_back({ p, pointId });
+        vector<LeafSlot> groupA, groupB;
+        rtree_detail::linearSplit(entries, (maxEntries_ + 1) / 2, [](const LeafSlot &s) { return boundsOf(s); }, groupA, groupB);
+        PageRef sibling(pool_, allocatePage(), true);
+        storeEntries(data, true, groupA);
+        storeEntries(sibling.mutableData(), true, groupB);
+        bounds = h.mbr;
+        siblingBounds = header(sibling.data()).mbr;
+        return sibling.id();
+    }
+
+    // Hijo con menor incremento de semiperimetro
+    BranchSlot* children = slots<BranchSlot>(data);
+    size_t best = 0;
+    float MAX = numeric_limits<float>::max();
+    for (size_t i = 0; i < h.count; ++i) {
+        float delta = children[i].mbr.deltaSemiPerimeter(p);
+        if (delta < MAX) {
+            MAX = delta;
+            best = i;
+        }
+    }
+
+    MBB childBounds, newBounds;
+    PageId split = insertAt(children[best].child, p, pointId, childBounds, newBounds);
+    children[best].mbr = childBounds;
+    h.mbr.expandToInclude(p);
+    if (split == kNoPage) {
+        bounds = h.mbr;
+        return kNoPage;
+    }
+    if (h.count < maxEntries_) {
+        children[h.count++] = { newBounds, split };
+        h.mbr.expandToInclude(newBounds);
+        bounds = h.mbr;
+        return kNoPage;
+    }
+    vector<BranchSlot> entries(children, children + h.count);
+    entries.push_back({ newBounds, split });
+    vector<BranchSlot> groupA, groupB;
+    rtree_detail::quadraticSplit(entries, (maxEntries_ + 1) / 2, [](const BranchSlot &s) { return boundsOf(s); }, groupA, groupB);
+    PageRef sibling(pool_, allocatePage(), true);
+    storeEntries(data, false, groupA);
+    storeEntries(sibling.mutableData(), false, groupB);
+    bounds = h.mbr;
+    siblingBounds = header(sibling.data()).mbr;
+    return sibling.id();
+}
+
+void PagedRTree::insert(const Point &p, EntryId id, IOStats* io) {
+    const IOStats before = pool_.stats();
+    if (root_ == kNoPage) {
+        root_ = allocatePage();
+        height_ = 1;
+        PageRef page(pool_, root_, true);
+        NodeHeader &h = header(page.mutableData());
+        h.isLeaf = 1;
+        h.count = 0;
+    }
+    MBB bounds, siblingBounds;
+    PageId split = insertAt(root_, p, id, bounds, siblingBounds);
+    if (split != kNoPage) {
+        PageId newRoot = allocatePage();
+        PageRef page(pool_, newRoot, true);
+        storeEntries(page.mutableData(), false, vector<BranchSlot>{ { bounds, root_ }, { siblingBounds, split } });
+        root_ = newRoot;
+        ++height_;
+    }
+    ++size_;
+    if (io) *io += pool_.stats() - before;
+}
+
+void PagedRTree::search(const MBB &query, vector<Point> &out, IOStats* io) {
+    const IOStats before = pool_.stats();
+    vector<PageId> stack;
+    if (root_ != kNoPage) stack.push_back(root_);
+    while (!stack.empty()) {
+        PageRef page(pool_, stack.back());
+        stack.pop_back();
+        const NodeHeader &h = header(page.data());
+        if (h.count == 0 || !h.mbr.overlaps(query)) continue;
+        if (h.isLeaf) {
+            const LeafSlot* entries = slots<LeafSlot>(page.data());
+            for (size_t i = 0; i < h.count; ++i)
+                if (query.contains(entries[i].pt)) out.push_back(entries[i].pt);
+        } else {
+            const BranchSlot* children = slots<BranchSlot>(page.data());
+            for (size_t i = 0; i < h.count; ++i)
+                if (children[i].mbr.overlaps(query)) stack.push_back(children[i].child);
+        }
+    }
+    if (io) *io += pool_.stats() - before;
+}
+
+vector<Point> PagedRTree::kNN(const Point &query, size_t k, IOStats* io) {
+    const IOStats before = pool_.stats();
+    if (root_ == kNoPage) return vector<Point>();
+    // Cada pagina queda fijada solo mientras se recorre
+    auto expand = [&](PageId id, auto &offer, auto &push) {
+        PageRef page(pool_, id);
+        const NodeHeader &h = header(page.data());
+        if (h.isLeaf) {
+            const LeafSlot* entries = slots<LeafSlot>(page.data());
+            for (size_t i = 0; i < h.count; ++i) offer(entries[i].pt.distanceSquaredTo(query), entries[i].pt);
+        } else {
+            const BranchSlot* children = slots<BranchSlot>(page.data());
+            for (size_t i = 0; i < h.count; ++i) push(children[i].mbr.distanceSquaredTo(query), children[i].child);
+        }
+    };
+    vector<Point> result = bestFirstKNN<Point>(root_, 0.0f, k, size_, numeric_limits<float>::infinity(), expand);
+    if (io) *io += pool_.stats() - before;
+    return result;
+}
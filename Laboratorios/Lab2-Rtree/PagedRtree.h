@@ -0,0 +1,191 @@
+// R-tree persistente: cada nodo es una pagina de tamano fijo (por ejemplo 4 KB
+// o 16 KB) de un archivo, identificada por su numero de pagina. Los nodos se
+// leen a traves de un buffer pool acotado con reemplazo CLOCK; las paginas se
+// fijan (pin) mientras se recorren.
+//
+// Usa los mismos algoritmos que RTree en modo CLASSIC_INSERT (menor
+// incremento de semiperimetro, split lineal en hojas y cuadratico en nodos
+// internos; rtree_detail::linearSplit / quadraticSplit), la busqueda por
+// rango con poda y el kNN best-first acotado (bestFirstKNN).
+// Cada operacion puede llenar un IOStats para dimensionar el pool.
+//
+// Formato del archivo: la pagina 0 guarda los metadatos (raiz, altura,
+// cantidad de paginas y de puntos); el resto son nodos.
+#ifndef PAGED_RTREE_H
+#define PAGED_RTREE_H
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "Rtree.h"
+
+typedef uint32_t PageId;
+const PageId kNoPage = 0;  // la pagina 0 es la de metadatos
+
+// Como abrir el archivo de paginas
+enum OpenMode {
+    OPEN_EXISTING,  // el archivo debe existir; no se modifica al abrir
+    CREATE_NEW      // crea el archivo o lo trunca si ya existe
+};
+
+// Contadores de entrada/salida de una operacion (o acumulados del pool)
+struct IOStats {
+    size_t pageRequests = 0;  // paginas pedidas al pool
+    size_t bufferHits = 0;    // pedidos servidos sin leer del archivo
+    size_t pageReads = 0;     // paginas leidas del archivo
+    size_t pageWrites = 0;    // paginas escritas (al desalojar o en flush)
+
+    IOStats &operator+=(const IOStats &o) {
+        pageRequests += o.pageRequests;
+        bufferHits += o.bufferHits;
+        pageReads += o.pageReads;
+        pageWrites += o.pageWrites;
+        return *this;
+    }
+    IOStats operator-(const IOStats &o) const {
+        IOStats r;
+        r.pageRequests = pageRequests - o.pageRequests;
+        r.bufferHits = bufferHits - o.bufferHits;
+        r.pageReads = pageReads - o.pageReads;
+        r.pageWrites = pageWrites - o.pageWrites;
+        return r;
+    }
+};
+
+// -------------------------------
+// Archivo de paginas
+// -------------------------------
+class PageFile {
+public:
+    PageFile(const std::string &path, size_t pageSize, OpenMode mode);
+
+    size_t pageSize() const { return pageSize_; }
+    void read(PageId id, char* out);
+    void write(PageId id, const char* data);
+    void flush() { file_.flush(); }
+
+private:
+    std::fstream file_;
+    size_t pageSize_;
+};
+
+// -------------------------------
+// Buffer pool (CLOCK)
+// -------------------------------
+class BufferPool {
+public:
+    BufferPool(PageFile &file, size_t frames);
+    ~BufferPool();
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    // Fija la pagina 'id' en un marco (leyendola si hace falta) y devuelve sus datos
+    char* pin(PageId id);
+    // Fija un marco para una pagina nueva, sin leer del archivo
+    char* pinNew(PageId id);
+    void unpin(PageId id, bool dirty);
+    // Escribe todas las paginas modificadas
+    void flush();
+
+    size_t frames() const { return frames_.size(); }
+    const IOStats &stats() const { return stats_; }
+
+private:
+    static const PageId kFreeFrame = 0xFFFFFFFFu;
+
+    struct Frame {
+        PageId page = kFreeFrame;
+        uint pins = 0;
+        bool dirty = false;
+        bool referenced = false;
+    };
+
+    PageFile &file_;
+    char* data_;  // frames_.size() paginas contiguas, alineadas a 64 bytes
+    std::vector<Frame> frames_;
+    std::unordered_map<PageId, size_t> table_;  // pagina -> marco
+    size_t hand_ = 0;
+    IOStats stats_;
+
+    char* frameData(size_t f) { return data_ + f * file_.pageSize(); }
+    // Marco libre o victima CLOCK (sin pins); escribe la victima si estaba sucia
+    size_t claimFrame(PageId id);
+};
+
+// Pagina fijada mientras vive el objeto
+class PageRef {
+public:
+    PageRef(BufferPool &pool, PageId id, bool fresh = false)
+        : pool_(&pool), id_(id), data_(fresh ? pool.pinNew(id) : pool.pin(id)) {}
+    ~PageRef() { pool_->unpin(id_, dirty_); }
+
+    PageRef(const PageRef &) = delete;
+    PageRef &operator=(const PageRef &) = delete;
+
+    PageId id() const { return id_; }
+    const char* data() const { return data_; }
+    // Acceso para modificar: la pagina se escribira al desalojarla
+    char* mutableData() {
+        dirty_ = true;
+        return data_;
+    }
+
+private:
+    BufferPool* pool_;
+    PageId id_;
+    char* data_;
+    bool dirty_ = false;
+};
+
+// -------------------------------
+// Clase PagedRTree
+// -------------------------------
+class PagedRTree {
+public:
+    // Abre el arbol guardado en 'path' (o lo crea vacio con CREATE_NEW).
+    // 'pageSize' debe ser multiplo de 64 y >= 256; se valida antes de tocar el
+    // archivo. 'poolPages' es la cantidad de marcos del buffer pool; debe
+    // superar la altura del arbol.
+    explicit PagedRTree(const std::string &path, size_t pageSize = 4096, size_t poolPages = 64,
+                        OpenMode mode = OPEN_EXISTING);
+    ~PagedRTree();
+
+    PagedRTree(const PagedRTree &) = delete;
+    PagedRTree &operator=(const PagedRTree &) = delete;
+
+    void insert(const Point &p, EntryId id, IOStats* io = nullptr);
+    void search(const MBB &query, std::vector<Point> &out, IOStats* io = nullptr);
+    std::vector<Point> search(const MBB &query) {
+        std::vector<Point> out;
+        search(query, out);
+        return out;
+    }
+    std::vector<Point> kNN(const Point &query, size_t k, IOStats* io = nullptr);
+
+    // Escribe las paginas modificadas y los metadatos
+    void flush();
+
+    size_t size() const { return size_; }
+    size_t height() const { return height_; }
+    size_t pageCount() const { return pageCount_; }
+    size_t maxEntries() const { return maxEntries_; }
+    const BufferPool &bufferPool() const { return pool_; }
+
+private:
+    PageFile file_;
+    BufferPool pool_;
+    PageId root_ = kNoPage;
+    size_t height_ = 0;
+    size_t pageCount_ = 1;  // incluye la de metadatos
+    size_t size_ = 0;
+    size_t maxEntries_ = 0;
+
+    PageId allocatePage() { return static_cast<PageId>(pageCount_++); }
+    void writeMeta();
+
+    // Inserta en el subarbol de 'id'; si la pagina se divide devuelve la nueva hermana
+    PageId insertAt(PageId id, const Point &p, EntryId pointId, MBB &bounds, MBB &siblingBounds);
+};
+
+#endif // PAGED_RTREE_H
@@ -1,3 +1,6 @@
+#ifndef RTREE_H
+#define RTREE_H
+
 #include <iostream>
 #include <vector>
 #include <queue>
@@ -7,116 +10,734 @@
 #include <cstdlib>
 #include <ctime>
 #include <cassert>
+#include <utility>
+#include <unordered_map>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <stdexcept>
 
 typedef unsigned int  uint;
 typedef unsigned char uchar;
+typedef uint64_t      EntryId;  // id de una entrada de hoja
+
+// Kernels de hijos (RNode::childMasks / childDistances): con -mavx2 (o -mavx)
+// se procesan 8 hijos por instruccion cuando Coord es float; en otro caso se
+// usa la version escalar.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RTREE_SIMD 1
+#endif
+
+// Plantillas: BasicRTree<Dim, Coord, Fanout>
+//  - Dim: dimensiones de los puntos (los bucles por eje se desenrollan).
+//  - Coord: tipo de coordenada (float, double, ...).
+//  - Fanout: capacidad de un nodo (M, maxEntries). Fija el tamano de los
+//    bloques del pool y de los arreglos SoA, asi que se elige al compilar.
+// Los alias Point, MBB, RNode y RTree conservan la API 2D en float con
+// M = 11. Las definiciones estan en Rtree.tpp (incluido al final de este
+// archivo), asi que cualquier <Dim, Coord, Fanout> se instancia al usarlo.
+
+// -------------------------------
+// Clase Point
+// -------------------------------
+// Almacenamiento: en 2D y 3D las coordenadas tienen nombre (x, y, z)
+template <size_t Dim, typename Coord>
+struct PointStorage {
+    Coord c[Dim];
+    PointStorage() : c() {}
+    explicit PointStorage(const Coord (&v)[Dim]) { std::copy(v, v + Dim, c); }
+    Coord &operator[](size_t i) { return c[i]; }
+    const Coord &operator[](size_t i) const { return c[i]; }
+};
 
-class Point {
+template <typename Coord>
+struct PointStorage<2, Coord> {
+    Coord x, y;
+    PointStorage() : x(0), y(0) {}
+    PointStorage(Coord x, Coord y) : x(x), y(y) {}
+    Coord &operator[](size_t i) { return i == 0 ? x : y; }
+    const Coord &operator[](size_t i) const { return i == 0 ? x : y; }
+};
+
+template <typename Coord>
+struct PointStorage<3, Coord> {
+    Coord x, y, z;
+    PointStorage() : x(0), y(0), z(0) {}
+    PointStorage(Coord x, Coord y, Coord z) : x(x), y(y), z(z) {}
+    Coord &operator[](size_t i) { return i == 0 ? x : (i == 1 ? y : z); }
+    const Coord &operator[](size_t i) const { return i == 0 ? x : (i == 1 ? y : z); }
+};
+
+template <size_t Dim, typename Coord>
+class BasicPoint : public PointStorage<Dim, Coord> {
 public:
-    float x, y;
-    Point() : x(0.0f), y(0.0f) {}
-    Point(float x, float y) : x(x), y(y) {}
+    static constexpr size_t dimensions = Dim;
+    typedef Coord coord_type;
+
+    using PointStorage<Dim, Coord>::PointStorage;
+    BasicPoint() = default;
 
     // Distancia euclidiana
-    float distanceTo(const Point &other) const {
-        float dx = x - other.x;
-        float dy = y - other.y;
-        return std::sqrt(dx * dx + dy * dy);
+    Coord distanceTo(const BasicPoint &other) const {
+        return std::sqrt(distanceSquaredTo(other));
     }
+
+    // Distancia al cuadrado (sin sqrt, para comparar)
+    Coord distanceSquaredTo(const BasicPoint &other) const {
+        Coord sum = 0;
+        for (size_t d = 0; d < Dim; ++d) {
+            Coord delta = (*this)[d] - other[d];
+            sum += delta * delta;
+        }
+        return sum;
+    }
+};
+
+template <size_t Dim, typename Coord, size_t Fanout> class BasicRNode;
+template <typename T> class EntryArray;
+
+// Estrategia de insercion del RTree
+enum InsertStrategy {
+    CLASSIC_INSERT,  // menor incremento de semiperimetro; split lineal/cuadratico
+    RSTAR_INSERT     // R*-tree: ChooseSubtree por solapamiento, split topologico y reinsercion forzada
 };
 
-class RNode;
+// Contenido de las hojas del RTree
+enum EntryKind {
+    POINT_ENTRIES,  // puntos: cada entrada guarda un solo punto
+    BOX_ENTRIES     // pares (MBB, id); un punto se guarda como caja degenerada
+};
 
-class MBB {
+// -------------------------------
+// Clase MBB
+// -------------------------------
+template <size_t Dim, typename Coord>
+class BasicMBB {
 public:
-    Point lower; // Esquina inferior izquierda
-    Point upper; // Esquina superior derecha
+    typedef BasicPoint<Dim, Coord> PointT;
+
+    PointT lower; // Esquina inferior izquierda
+    PointT upper; // Esquina superior derecha
 
-    MBB() : lower(Point()), upper(Point()) {}
-    MBB(const Point &p1, const Point &p2)
-        : lower(Point(std::min(p1.x, p2.x), std::min(p1.y, p2.y))),
-          upper(Point(std::max(p1.x, p2.x), std::max(p1.y, p2.y))) {}
+    BasicMBB() : lower(PointT()), upper(PointT()) {}
+    BasicMBB(const PointT &p1, const PointT &p2) {
+        for (size_t d = 0; d < Dim; ++d) {
+            lower[d] = std::min(p1[d], p2[d]);
+            upper[d] = std::max(p1[d], p2[d]);
+        }
+    }
 
-    float area() const;
-    float semiPerimeter() const;
+    // Area (volumen en 3D o mas)
+    Coord area() const;
+    // Suma de los lados (margen)
+    Coord semiPerimeter() const;
 
-    float distanceTo(const Point &p) const;
+    Coord distanceTo(const PointT &p) const;
+    Coord distanceSquaredTo(const PointT &p) const;
 
-    // Incremento del semiperimetro si agrega p
-    float deltaSemiPerimeter(const Point &p) const;
+    // Incremento del semiperimetro si agrega p o box
+    Coord deltaSemiPerimeter(const PointT &p) const;
+    Coord deltaSemiPerimeter(const BasicMBB &box) const;
 
     // Expande para incluir point o MBB
-    void expandToInclude(const Point &p);
-    void expandToInclude(const MBB &other);
+    void expandToInclude(const PointT &p);
+    void expandToInclude(const BasicMBB &other);
 
     // Retorna el area de interseccion
-    float intersects(const MBB &other) const;
-    
-    // Crear MBB a partir de un vector de puntos
-    static MBB computeFromPoints(const std::vector<Point> &pts);
+    Coord intersects(const BasicMBB &other) const;
 
-    // Crear MBB a partir de un vector de nodos
-    static MBB computeFromNodes(const std::vector<RNode*> &nodes);
+    // ¿Se tocan o solapan? (los roces cuentan)
+    bool overlaps(const BasicMBB &other) const {
+        for (size_t d = 0; d < Dim; ++d) {
+            if (lower[d] > other.upper[d] || other.lower[d] > upper[d]) return false;
+        }
+        return true;
+    }
+    // ¿'other' queda completamente dentro (bordes incluidos)?
+    bool contains(const BasicMBB &other) const {
+        for (size_t d = 0; d < Dim; ++d) {
+            if (other.lower[d] < lower[d] || other.upper[d] > upper[d]) return false;
+        }
+        return true;
+    }
+    bool contains(const PointT &p) const {
+        for (size_t d = 0; d < Dim; ++d) {
+            if (p[d] < lower[d] || p[d] > upper[d]) return false;
+        }
+        return true;
+    }
+
+    // Crear MBB a partir de un vector (o EntryArray) de puntos
+    template <typename Points>
+    static BasicMBB computeFromPoints(const Points &pts) {
+        assert(!pts.empty());
+        BasicMBB result(pts[0], pts[0]);
+        for (size_t i = 1; i < pts.size(); ++i) result.expandToInclude(pts[i]);
+        return result;
+    }
+
+    // Crear MBB a partir de un vector (o EntryArray) de nodos
+    template <typename Nodes>
+    static BasicMBB computeFromNodes(const Nodes &nodes) {
+        assert(!nodes.empty());
+        BasicMBB result = nodes[0]->mbr;
+        for (size_t i = 1; i < nodes.size(); ++i) result.expandToInclude(nodes[i]->mbr);
+        return result;
+    }
 
     // Union MBBs
-    static MBB unionOf(const MBB &a, const MBB &b);
+    static BasicMBB unionOf(const BasicMBB &a, const BasicMBB &b);
 };
 
 
+// -------------------------------
+// Arreglo de entradas de capacidad fija
+// -------------------------------
+// Las entradas de un nodo viven en el mismo bloque que el nodo (ver NodePool),
+// sin reservas propias. Ofrece la parte de la API de std::vector que usa el
+// arbol; T debe ser trivialmente copiable (Point, uint, RNode*).
+// La capacidad es Fanout + 1: un nodo desborda con una entrada de mas y se
+// divide enseguida. Pasarse de ella lanza length_error en vez de escribir
+// sobre el bloque siguiente del pool.
+template <typename T>
+class EntryArray {
+private:
+    T* data_ = nullptr;
+    uint size_ = 0;
+    uint capacity_ = 0;
+
+public:
+    EntryArray() = default;
+    EntryArray(const EntryArray &) = delete;
+    EntryArray &operator=(const EntryArray &) = delete;
+
+    void bind(T* storage, uint capacity) {
+        data_ = storage;
+        size_ = 0;
+        capacity_ = capacity;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    T &operator[](size_t i) { return data_[i]; }
+    const T &operator[](size_t i) const { return data_[i]; }
+    T &back() { return data_[size_ - 1]; }
+
+    void push_back(const T &value) {
+        if (size_ == capacity_) throw std::length_error("EntryArray: se supero la capacidad del nodo");
+        new (data_ + size_) T(value);
+        ++size_;
+    }
+    void pop_back() { --size_; }
+    void clear() { size_ = 0; }
+    void resize(size_t n) {
+        if (n > capacity_) throw std::length_error("EntryArray: se supero la capacidad del nodo");
+        for (size_t i = size_; i < n; ++i) new (data_ + i) T();
+        size_ = static_cast<uint>(n);
+    }
+    template <typename It>
+    void assign(It first, It last) {
+        clear();
+        for (; first != last; ++first) push_back(*first);
+    }
+    T* erase(T* pos) { return erase(pos, pos + 1); }
+    T* erase(T* first, T* last) {
+        std::copy(last, end(), first);
+        size_ -= static_cast<uint>(last - first);
+        return first;
+    }
+};
+
+// Entrada de una hoja: caja (degenerada para puntos), id y peso
+template <size_t Dim, typename Coord>
+struct BasicLeafEntry {
+    BasicMBB<Dim, Coord> box;
+    EntryId id;
+    float weight;
+};
+
+// Contadores de una busqueda por rango
+struct SearchStats {
+    size_t nodesVisited = 0;    // nodos cuyo MBB toca la consulta
+    size_t nodesPruned = 0;     // subarboles descartados sin bajar
+    size_t nodesContained = 0;  // subarboles dentro de la consulta: se emiten sin probar puntos
+
+    SearchStats &operator+=(const SearchStats &o) {
+        nodesVisited += o.nodesVisited;
+        nodesPruned += o.nodesPruned;
+        nodesContained += o.nodesContained;
+        return *this;
+    }
+};
+
+// Totales de un subarbol o de una consulta: cantidad de puntos y suma de pesos
+struct Aggregate {
+    size_t count = 0;
+    double weightSum = 0;
+
+    Aggregate &operator+=(const Aggregate &o) {
+        count += o.count;
+        weightSum += o.weightSum;
+        return *this;
+    }
+};
+
+template <size_t Dim, typename Coord, size_t Fanout> class BasicNodePool;
+
 // -------------------------------
 // Clase RNode
 // -------------------------------
-class RNode {
+// Los nodos se crean con NodePool::create, que reserva en el mismo bloque
+// alineado a linea de cache el espacio de points, uppers, ids, weights y
+// children. Con POINT_ENTRIES no se reserva 'uppers': la entrada i es el
+// punto points[i]; con BOX_ENTRIES es la caja [points[i], uppers[i]].
+template <size_t Dim, typename Coord, size_t Fanout>
+class BasicRNode {
+    friend class BasicNodePool<Dim, Coord, Fanout>;
+
+public:
+    typedef BasicPoint<Dim, Coord> PointT;
+    typedef BasicMBB<Dim, Coord> MBBT;
+    typedef BasicLeafEntry<Dim, Coord> LeafEntryT;
+    typedef BasicNodePool<Dim, Coord, Fanout> PoolT;
+
+    // Hijos como maximo (Fanout mas el desborde previo a un split), con
+    // relleno hasta multiplo de 8 para los kernels, y palabras de sus mascaras
+    static constexpr size_t kMaxChildren = Fanout + 1;
+    static constexpr size_t kChildSlots = (kMaxChildren + 7) / 8 * 8;
+    static constexpr size_t kMaskWords = (kMaxChildren + 63) / 64;
+
 private:
+    PoolT* pool;
+
+    BasicRNode(bool leaf, bool boxEntries, PoolT* pool) : pool(pool), isLeaf(leaf), boxEntries(boxEntries) {}
+
     // Linear Split para nodos hojas
-    RNode* linearSplitLeaf(uchar maxEntries);
+    BasicRNode* linearSplitLeaf();
 
     // Quadratic Split para nodos internos
-    RNode* quadraticSplitInternal(uchar maxEntries);
+    BasicRNode* quadraticSplitInternal();
 
 public:
     bool isLeaf;
-    MBB mbr;
-    std::vector<Point>    points;
-    std::vector<RNode*> children;
+    bool boxEntries;                   // hojas con cajas (BOX_ENTRIES)
+    MBBT mbr;
+    EntryArray<PointT>      points;    // punto, o esquina inferior de la caja
+    EntryArray<PointT>      uppers;    // esquina superior (solo BOX_ENTRIES)
+    EntryArray<EntryId>     ids;       // id de cada entrada (paralelo a points)
+    EntryArray<float>       weights;   // peso de cada entrada (paralelo a points)
+    EntryArray<BasicRNode*> children;
+    Aggregate summary;                 // totales del subarbol
+
+    // MBBs de los hijos en SoA (solo nodos internos; comparten espacio con
+    // las entradas de hoja). Rellenos hasta multiplo de 8 con cajas vacias (+inf, -inf).
+    Coord* childLow[Dim];
+    Coord* childUp[Dim];
+
+    BasicRNode(const BasicRNode &) = delete;
+    BasicRNode &operator=(const BasicRNode &) = delete;
+
+    // Caja de la entrada i de una hoja
+    MBBT entryBox(size_t i) const {
+        MBBT box;
+        box.lower = points[i];
+        box.upper = boxEntries ? uppers[i] : points[i];
+        return box;
+    }
+    // ¿La entrada i toca 'query'? (para puntos: esta dentro)
+    bool entryTouches(const MBBT &query, size_t i) const {
+        return boxEntries ? query.overlaps(entryBox(i)) : query.contains(points[i]);
+    }
+    void pushEntry(const LeafEntryT &entry);
+    void eraseEntry(size_t i);
+
+    BasicRNode* insert(const LeafEntryT &entry);
+    std::vector<PointT> search(const MBBT &query) const;
+    // Agrega a 'out' los puntos dentro de 'query' sin reservar memoria intermedia
+    void search(const MBBT &query, std::vector<PointT> &out, SearchStats* stats = nullptr) const;
 
-    RNode(bool leaf) : isLeaf(leaf) {}
+    // Recorre en profundidad con una pila explicita y llama visitor(p) por cada
+    // punto dentro de 'query'. Si visitor devuelve false se detiene y retorna false.
+    // Los subarboles que no tocan la consulta se descartan y los que quedan
+    // dentro se emiten completos sin comparar punto a punto.
+    template <typename Visitor>
+    bool visit(const MBBT &query, Visitor &&visitor, SearchStats* stats = nullptr) const;
+    // Igual que visit, pero llama visitor(leaf, i) por cada entrada que toca 'query'
+    template <typename Visitor>
+    bool visitEntries(const MBBT &query, Visitor &&visitor, SearchStats* stats = nullptr) const;
 
-    RNode* insert(const Point &p, uchar maxEntries);
-    std::vector<Point> search(const MBB &query) const;
+    // Suma a 'total' los puntos dentro de 'query'. Los hijos que quedan dentro
+    // aportan su summary sin bajar por ellos.
+    void accumulate(const MBBT &query, Aggregate &total, SearchStats* stats = nullptr) const;
+
+    // Recalcula el MBB minimo y summary a partir de las entradas (y, en nodos
+    // internos, los limites SoA de los hijos)
+    void refreshMBR();
+
+    // Copia a los arreglos SoA el MBB del hijo i, o el de todos los hijos
+    void setChildBounds(size_t i);
+    void syncChildBounds();
+
+    // Bit i de 'overlap': el hijo i toca 'query'; de 'inside': esta dentro
+    void childMasks(const MBBT &query, uint64_t* overlap, uint64_t* inside) const;
+    // out[i] = distancia minima al cuadrado de 'query' al MBB del hijo i
+    // ('out' debe tener kChildSlots elementos)
+    void childDistances(const PointT &query, Coord* out) const;
+
+    // Entradas de una hoja como (caja, id, peso)
+    std::vector<LeafEntryT> leafEntries() const;
+    void setLeafEntries(const std::vector<LeafEntryT> &entries);
+
+    // ---- R*-tree ----
+    // Hijo donde insertar 'box': menor incremento de solapamiento si los hijos
+    // son hojas, menor incremento de area en otro caso.
+    BasicRNode* chooseSubtreeRStar(const MBBT &box) const;
+    // Split topologico: eje de menor suma de margenes y, en ese eje, la
+    // distribucion de menor solapamiento (desempate por area)
+    BasicRNode* rstarSplit();
+    // Quita las 'count' entradas mas lejanas del centro del nodo
+    std::vector<LeafEntryT> takeFarthestPoints(size_t count);
+    std::vector<BasicRNode*> takeFarthestChildren(size_t count);
 };
 
 
 
+// -------------------------------
+// Pool de nodos
+// -------------------------------
+// Reparte bloques de tamano fijo (nodo + kMaxChildren entradas de cada tipo),
+// redondeados a 64 bytes, desde slabs alineados a linea de cache. Los nodos
+// liberados vuelven a una lista libre; clear() devuelve todos los slabs.
+template <size_t Dim, typename Coord, size_t Fanout>
+class BasicNodePool {
+public:
+    typedef BasicRNode<Dim, Coord, Fanout> Node;
+    static constexpr size_t kCacheLine = 64;
+
+    explicit BasicNodePool(bool boxEntries);
+    ~BasicNodePool() { clear(); }
+
+    BasicNodePool(const BasicNodePool &) = delete;
+    BasicNodePool &operator=(const BasicNodePool &) = delete;
+
+    Node* create(bool leaf);
+    void release(Node* node);
+    // Libera todos los nodos de una vez (sin recorrer el arbol)
+    void clear();
+
+    size_t slotSize() const { return slotSize_; }
+    size_t nodesInUse() const { return inUse_; }
+    size_t bytesReserved() const { return slabs_.size() * slotsPerSlab_ * slotSize_; }
+
+private:
+    size_t capacity_;
+    bool boxEntries_;
+    size_t childrenOffset_, pointsOffset_, uppersOffset_, idsOffset_, weightsOffset_, boundsOffset_, boundsStride_;
+    size_t slotSize_;
+    size_t slotsPerSlab_;
+    std::vector<char*> slabs_;
+    size_t nextSlot_;   // siguiente bloque sin usar del ultimo slab
+    void* freeList_;    // bloques liberados (enlazados por su primer puntero)
+    size_t inUse_;
+};
+
 // -------------------------------
 // Para Best-First
 // -------------------------------
-struct QueueEntry {
-    float distance;  // Distancia desde el query al MBB
+template <typename Node>
+struct BasicQueueEntry {
+    typename Node::PointT::coord_type distance;  // Distancia (al cuadrado en kNN) desde el query al MBB
     bool isNode;     // Si true, es un nodo; si false, es un punto
-    RNode* node;
-    Point pt;
+    Node* node;
+    typename Node::PointT pt;
 };
 
 struct QueueEntryComparator {
-    bool operator()(const QueueEntry &a, const QueueEntry &b) const {
+    template <typename Entry>
+    bool operator()(const Entry &a, const Entry &b) const {
         return a.distance > b.distance;
     }
 };
 
+// kNN best-first acotado, comun a RTree, PagedRTree y HilbertRTree: cola de
+// nodos por distancia minima (al cuadrado) y max-heap con las k mejores
+// entradas. expand(node, offer, push) recorre un nodo y llama offer(dist, item)
+// por cada entrada de hoja y push(dist, hijo) por cada hijo; ambas descartan
+// lo que quede mas lejos que 'limit' o que el k-esimo actual. 'size' es la
+// cantidad de entradas del arbol: acota la reserva del heap para k grandes.
+// Devuelve los items ordenados por distancia.
+template <typename Item, typename Coord, typename NodeRef, typename Expand>
+std::vector<Item> bestFirstKNN(NodeRef root, Coord rootDist, size_t k, size_t size, Coord limit, Expand &&expand) {
+    struct Pending {
+        Coord distance;
+        NodeRef node;
+    };
+    typedef std::pair<Coord, Item> Candidate;
+    std::vector<Item> result;
+    if (k == 0 || size == 0) return result;
+
+    std::priority_queue<Pending, std::vector<Pending>, QueueEntryComparator> pq;
+    std::vector<Candidate> best;
+    best.reserve(std::min(k, size));
+    auto farther = [](const Candidate &a, const Candidate &b) { return a.first < b.first; };
+    auto bound = [&]() { return best.size() < k ? limit : best.front().first; };
+    auto offer = [&](Coord dist, const Item &item) {
+        if (dist > bound()) return;
+        if (best.size() == k) {
+            std::pop_heap(best.begin(), best.end(), farther);
+            best.pop_back();
+        }
+        best.push_back({ dist, item });
+        std::push_heap(best.begin(), best.end(), farther);
+    };
+    auto push = [&](Coord dist, NodeRef node) {
+        if (dist <= bound()) pq.push({ dist, node });
+    };
+
+    pq.push({ rootDist, root });
+    while (!pq.empty()) {
+        Pending current = pq.top();
+        pq.pop();
+        // El resto de la cola esta mas lejos que el k-esimo actual
+        if (current.distance > bound()) break;
+        expand(current.node, offer, push);
+    }
+
+    std::sort_heap(best.begin(), best.end(), farther);
+    result.reserve(best.size());
+    for (const Candidate &c : best) result.push_back(c.second);
+    return result;
+}
+
 // -------------------------------
 // Clase RTree
 // -------------------------------
-class RTree {
+template <size_t Dim, typename Coord, size_t Fanout>
+class BasicRTree {
 public:
-    RNode* root;
-    uchar maxEntries;  // Capacidad maxima
+    typedef BasicPoint<Dim, Coord> PointT;
+    typedef BasicMBB<Dim, Coord> MBBT;
+    typedef BasicRNode<Dim, Coord, Fanout> Node;
+    typedef BasicNodePool<Dim, Coord, Fanout> PoolT;
+    typedef BasicLeafEntry<Dim, Coord> LeafEntryT;
+    static constexpr size_t dimensions = Dim;
+    static constexpr size_t maxEntries = Fanout;  // Capacidad maxima de un nodo
+    static_assert(Fanout >= 2, "un nodo debe poder guardar al menos 2 entradas");
+
+    Node* root;
+    InsertStrategy strategy;
+    EntryKind entryKind;
 
-    RTree(uchar maxEntries = 3) : maxEntries(maxEntries) {
-        root = new RNode(true);
+    explicit BasicRTree(InsertStrategy strategy = CLASSIC_INSERT, EntryKind entryKind = POINT_ENTRIES)
+        : strategy(strategy), entryKind(entryKind), pool(entryKind == BOX_ENTRIES) {
+        root = pool.create(true);
     }
+    // Los nodos se liberan junto con el pool
+    ~BasicRTree() = default;
 
-    void insert(const Point &p);
-    std::vector<Point> search(const MBB &query) const;
-    std::vector<Point> kNN(const Point &query, uchar k) const;
+    BasicRTree(const BasicRTree &) = delete;
+    BasicRTree &operator=(const BasicRTree &) = delete;
+
+    // Vacia el arbol y devuelve la memoria de todos los nodos
+    void clear();
+    const PoolT &nodePool() const { return pool; }
+
+    // Inserta con un id nuevo y lo devuelve
+    EntryId insert(const PointT &p);
+    // Inserta con un id y un peso dados; si el id ya existe, equivale a
+    // update(id, p) y conserva el peso anterior. Tras bulkLoad, la primera
+    // insercion con id (o el primer update) arma el indice de ids: O(n).
+    void insert(const PointT &p, EntryId id, float weight = 0.0f);
+    // Inserta una caja (solo con BOX_ENTRIES)
+    void insert(const MBBT &box, EntryId id, float weight = 0.0f);
+    // Quita el punto 'p' (o la caja 'box') con ese id. Los nodos que quedan
+    // por debajo de (maxEntries + 1) / 2 entradas se eliminan y sus entradas
+    // se reinsertan.
+    bool remove(const PointT &p, EntryId id);
+    bool remove(const MBBT &box, EntryId id);
+    // Mueve la entrada 'id' a 'newPos' (o 'newBox'). Si sigue dentro del MBB
+    // de su hoja se modifica en el lugar; si no, se quita y se reinserta.
+    bool update(EntryId id, const PointT &newPos);
+    bool update(EntryId id, const MBBT &newBox);
+    size_t size() const { return entryCount; }
+
+    std::vector<PointT> search(const MBBT &query) const;
+    void search(const MBBT &query, std::vector<PointT> &out, SearchStats* stats = nullptr) const;
+    // visitor(p) -> bool; devuelve false si el visitor corto el recorrido
+    template <typename Visitor>
+    bool search(const MBBT &query, Visitor &&visitor, SearchStats* stats = nullptr) const {
+        return root->visit(query, std::forward<Visitor>(visitor), stats);
+    }
+    // ¿Hay algun punto dentro de 'query'? Se detiene en el primero.
+    bool containsAny(const MBBT &query) const;
+    // Cantidad de puntos y suma de pesos dentro de 'query', sin materializar
+    // los puntos: los subarboles cubiertos aportan sus totales guardados
+    Aggregate aggregate(const MBBT &query, SearchStats* stats = nullptr) const;
+    size_t count(const MBBT &query) const { return aggregate(query).count; }
+
+    // Ids de las entradas que tocan 'query' (para puntos: que estan dentro).
+    // El resultado ocupa solo un id por entrada; el contenido lo busca el
+    // llamador en su propio almacenamiento.
+    std::vector<EntryId> searchIds(const MBBT &query) const;
+    void searchIds(const MBBT &query, std::vector<EntryId> &out, SearchStats* stats = nullptr) const;
+    // Ids de las k entradas mas cercanas a 'query', ordenados por distancia
+    std::vector<EntryId> kNNIds(const PointT &query, size_t k,
+                                Coord maxDist = std::numeric_limits<Coord>::infinity()) const;
+    // Los k puntos mas cercanos, ordenados por distancia. Con 'maxDist' solo se
+    // consideran los puntos a distancia <= maxDist.
+    // En un arbol de cajas devuelve la esquina inferior de cada una (usar kNNIds).
+    std::vector<PointT> kNN(const PointT &query, size_t k,
+                            Coord maxDist = std::numeric_limits<Coord>::infinity()) const;
+
+    // Carga masiva Sort-Tile-Recursive: reemplaza el contenido del arbol.
+    // 'fill' es la ocupacion objetivo de cada nodo (1.0 = maxEntries); nunca
+    // se baja de (maxEntries + 1) / 2 entradas por nodo no raiz. 'weights',
+    // si no esta vacio, da el peso de cada punto.
+    void bulkLoad(std::vector<PointT> points, float fill = 1.0f, const std::vector<float> &weights = {});
+    // Igual, con cajas (solo BOX_ENTRIES); los ids son las posiciones en 'boxes'
+    void bulkLoad(const std::vector<MBBT> &boxes, float fill = 1.0f, const std::vector<float> &weights = {});
+
+private:
+    PoolT pool;  // bloques de Fanout + 1 entradas: un nodo desborda antes de dividirse
+    // Caja actual de cada id, para update y para detectar ids repetidos.
+    // bulkLoad no lo llena (costaria mas que la carga en tiempo y memoria):
+    // buildPositions() lo arma recorriendo las hojas cuando hace falta.
+    std::unordered_map<EntryId, MBBT> positions;
+    bool positionsBuilt = true;
+    size_t entryCount = 0;
+    EntryId nextId = 0;
+
+    void buildPositions();
+
+    // Inserta en el arbol segun 'strategy', sin tocar 'positions'
+    void insertEntry(const LeafEntryT &entry);
+    void bulkLoadEntries(std::vector<LeafEntryT> entries, float fill);
+    // Los k vecinos mas cercanos como (hoja, indice)
+    std::vector<std::pair<const Node*, size_t>> nearestEntries(const PointT &query, size_t k, Coord maxDist) const;
+
+    // Camino raiz-hoja hasta la hoja que guarda (box, id) e indice dentro de ella
+    static bool findLeaf(Node* node, const MBBT &box, EntryId id, std::vector<Node*> &path, size_t &index);
+
+    // Tras quitar una entrada de path.back(): elimina los nodos con pocas
+    // entradas, ajusta los MBBs, acorta la raiz y reinserta las huerfanas
+    void condenseTree(std::vector<Node*> &path);
+
+    // Niveles del arbol (una hoja raiz tiene altura 1)
+    size_t height() const;
+
+    // Insercion R*: coloca un punto (level 0) o un subarbol (level = su altura)
+    // en un nodo del nivel correspondiente. 'reinserted[l]' marca los niveles
+    // que ya hicieron reinsercion forzada durante esta insercion.
+    void insertRStar(const LeafEntryT &entry, Node* subtree, size_t level, std::vector<char> &reinserted);
 };
+
+// -------------------------------
+// API 2D en float
+// -------------------------------
+typedef BasicPoint<2, float> Point;
+typedef BasicMBB<2, float> MBB;
+typedef BasicRTree<2, float, 11> RTree;
+typedef RTree::Node RNode;
+typedef RTree::PoolT NodePool;
+typedef BasicLeafEntry<2, float> LeafEntry;
+typedef BasicQueueEntry<RNode> QueueEntry;
+
+
+// -------------------------------
+// Recorrido con visitor
+// -------------------------------
+inline bool maskBit(const uint64_t* mask, size_t i) { return (mask[i / 64] >> (i % 64)) & 1u; }
+
+template <size_t Dim, typename Coord, size_t Fanout>
+template <typename Visitor>
+bool BasicRNode<Dim, Coord, Fanout>::visit(const MBBT &query, Visitor &&visitor, SearchStats* stats) const {
+    return visitEntries(query, [&visitor](const BasicRNode &leaf, size_t i) { return visitor(leaf.points[i]); }, stats);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+template <typename Visitor>
+bool BasicRNode<Dim, Coord, Fanout>::visitEntries(const MBBT &query, Visitor &&visitor, SearchStats* stats) const {
+    // Pila de (nodo, siguiente hijo): su tamano es la profundidad, no el ancho
+    struct Frame {
+        const BasicRNode* node;
+        size_t next;
+        bool contained;               // el MBB del nodo esta dentro de la consulta
+        uint64_t overlap[kMaskWords]; // hijos que tocan la consulta
+        uint64_t inside[kMaskWords];  // hijos dentro de la consulta
+    };
+    const size_t kMaxDepth = 64;
+    Frame stack[kMaxDepth];
+    size_t top = 0;
+
+    // Apila un nodo; los internos evaluan a todos sus hijos de una pasada
+    auto push = [&](const BasicRNode* node, bool contained) {
+        Frame &frame = stack[top++];
+        frame.node = node;
+        frame.next = 0;
+        frame.contained = contained;
+        if (stats) ++stats->nodesVisited;
+        if (!node->isLeaf && !contained) {
+            node->childMasks(query, frame.overlap, frame.inside);
+            if (stats) {
+                size_t hits = 0;
+                for (size_t w = 0; w < kMaskWords; ++w) hits += __builtin_popcountll(frame.overlap[w]);
+                stats->nodesPruned += node->children.size() - hits;
+            }
+        }
+    };
+
+    // Un MBB por defecto (raiz vacia) no debe tocar la consulta
+    if (isLeaf && points.empty()) return true;
+    if (!mbr.overlaps(query)) {
+        if (stats) ++stats->nodesPruned;
+        return true;
+    }
+    push(this, query.contains(mbr));
+    if (stats && stack[0].contained) ++stats->nodesContained;
+    while (top > 0) {
+        Frame &frame = stack[top - 1];
+        const BasicRNode* node = frame.node;
+        if (node->isLeaf) {
+            for (size_t i = 0; i < node->points.size(); ++i) {
+                if ((frame.contained || node->entryTouches(query, i)) && !visitor(*node, i)) return false;
+            }
+            --top;
+            continue;
+        }
+        const size_t n = node->children.size();
+        if (!frame.contained) {
+            while (frame.next < n && !maskBit(frame.overlap, frame.next)) ++frame.next;
+        }
+        if (frame.next == n) {
+            --top;
+            continue;
+        }
+        size_t i = frame.next++;
+        const BasicRNode* child = node->children[i];
+        if (top == kMaxDepth) {  // arbol mas profundo que la pila
+            if (!child->visitEntries(query, visitor, stats)) return false;
+            continue;
+        }
+        bool contained = frame.contained;
+        if (!contained && maskBit(frame.inside, i)) {
+            contained = true;
+            if (stats) ++stats->nodesContained;
+        }
+        push(child, contained);
+    }
+    return true;
+}
+
+#include "Rtree.tpp"
+
+#endif // RTREE_H
@@ -0,0 +1,1208 @@
+// Definiciones de las plantillas de Rtree.h; se incluye al final de ese archivo.
+//---------------------- MBB --------------------
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::area() const {
+    Coord result = 1;
+    for (size_t d = 0; d < Dim; ++d) result *= upper[d] - lower[d];
+    return result;
+}
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::semiPerimeter() const {
+    Coord result = 0;
+    for (size_t d = 0; d < Dim; ++d) result += upper[d] - lower[d];
+    return result;
+}
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::distanceTo(const PointT &p) const {
+    return std::sqrt(distanceSquaredTo(p));
+}
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::distanceSquaredTo(const PointT &p) const {
+    Coord result = 0;
+    for (size_t d = 0; d < Dim; ++d) {
+        Coord delta = std::max({ lower[d] - p[d], Coord(0), p[d] - upper[d] });
+        result += delta * delta;
+    }
+    return result;
+}
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::deltaSemiPerimeter(const PointT &p) const {
+    BasicMBB temp = *this;
+    temp.expandToInclude(p);
+    return temp.semiPerimeter() - semiPerimeter();
+}
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::deltaSemiPerimeter(const BasicMBB &box) const {
+    BasicMBB temp = *this;
+    temp.expandToInclude(box);
+    return temp.semiPerimeter() - semiPerimeter();
+}
+
+template <size_t Dim, typename Coord>
+void BasicMBB<Dim, Coord>::expandToInclude(const PointT &p) {
+    for (size_t d = 0; d < Dim; ++d) {
+        lower[d] = std::min(lower[d], p[d]);
+        upper[d] = std::max(upper[d], p[d]);
+    }
+}
+
+template <size_t Dim, typename Coord>
+void BasicMBB<Dim, Coord>::expandToInclude(const BasicMBB &other) {
+    for (size_t d = 0; d < Dim; ++d) {
+        lower[d] = std::min(lower[d], other.lower[d]);
+        upper[d] = std::max(upper[d], other.upper[d]);
+    }
+}
+
+template <size_t Dim, typename Coord>
+Coord BasicMBB<Dim, Coord>::intersects(const BasicMBB &other) const {
+    Coord result = 1;
+    for (size_t d = 0; d < Dim; ++d) {
+        result *= std::max(Coord(0), std::min(upper[d], other.upper[d]) - std::max(lower[d], other.lower[d]));
+    }
+    return result;
+}
+
+template <size_t Dim, typename Coord>
+BasicMBB<Dim, Coord> BasicMBB<Dim, Coord>::unionOf(const BasicMBB &a, const BasicMBB &b) {
+    BasicMBB result = a;
+    result.expandToInclude(b);
+    return result;
+}
+
+
+//---------------------- NodePool --------------------
+namespace rtree_detail {
+inline size_t alignUp(size_t n, size_t alignment) { return (n + alignment - 1) / alignment * alignment; }
+} // namespace rtree_detail
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicNodePool<Dim, Coord, Fanout>::BasicNodePool(bool boxEntries)
+    : capacity_(Node::kMaxChildren), boxEntries_(boxEntries), slabs_(), nextSlot_(0), freeList_(nullptr), inUse_(0) {
+    typedef typename Node::PointT PointT;
+    // [RNode][children][points][uppers][ids][weights], todo dentro de un bloque
+    // multiplo de 64 bytes. 'uppers' solo ocupa lugar con BOX_ENTRIES.
+    const size_t uppersCapacity = boxEntries_ ? capacity_ : 0;
+    childrenOffset_ = rtree_detail::alignUp(sizeof(Node), alignof(Node*));
+    pointsOffset_ = rtree_detail::alignUp(childrenOffset_ + capacity_ * sizeof(Node*), alignof(PointT));
+    uppersOffset_ = pointsOffset_ + capacity_ * sizeof(PointT);
+    idsOffset_ = rtree_detail::alignUp(uppersOffset_ + uppersCapacity * sizeof(PointT), alignof(EntryId));
+    weightsOffset_ = rtree_detail::alignUp(idsOffset_ + capacity_ * sizeof(EntryId), alignof(float));
+    size_t leafEnd = weightsOffset_ + capacity_ * sizeof(float);
+    // Los nodos internos usan el espacio de las entradas de hoja para los 2 * Dim
+    // arreglos SoA, alineados a 32 bytes y con longitud multiplo de 8
+    boundsOffset_ = rtree_detail::alignUp(pointsOffset_, 32);
+    boundsStride_ = rtree_detail::alignUp(capacity_, 8);
+    size_t internalEnd = boundsOffset_ + 2 * Dim * boundsStride_ * sizeof(Coord);
+    slotSize_ = rtree_detail::alignUp(std::max(leafEnd, internalEnd), kCacheLine);
+    slotsPerSlab_ = std::max<size_t>(16, (size_t(64) << 10) / slotSize_);
+    nextSlot_ = slotsPerSlab_;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicRNode<Dim, Coord, Fanout>* BasicNodePool<Dim, Coord, Fanout>::create(bool leaf) {
+    typedef typename Node::PointT PointT;
+    char* slot;
+    if (freeList_) {
+        slot = static_cast<char*>(freeList_);
+        freeList_ = *static_cast<void**>(freeList_);
+    } else {
+        if (nextSlot_ == slotsPerSlab_) {
+            slabs_.push_back(static_cast<char*>(::operator new(slotsPerSlab_ * slotSize_, std::align_val_t(kCacheLine))));
+            nextSlot_ = 0;
+        }
+        slot = slabs_.back() + nextSlot_++ * slotSize_;
+    }
+    Node* node = new (slot) Node(leaf, boxEntries_, this);
+    node->children.bind(reinterpret_cast<Node**>(slot + childrenOffset_), static_cast<uint>(capacity_));
+    node->points.bind(reinterpret_cast<PointT*>(slot + pointsOffset_), static_cast<uint>(capacity_));
+    node->uppers.bind(reinterpret_cast<PointT*>(slot + uppersOffset_), static_cast<uint>(boxEntries_ ? capacity_ : 0));
+    node->ids.bind(reinterpret_cast<EntryId*>(slot + idsOffset_), static_cast<uint>(capacity_));
+    node->weights.bind(reinterpret_cast<float*>(slot + weightsOffset_), static_cast<uint>(capacity_));
+    Coord* bounds = reinterpret_cast<Coord*>(slot + boundsOffset_);
+    for (size_t d = 0; d < Dim; ++d) {
+        node->childLow[d] = bounds + d * boundsStride_;
+        node->childUp[d] = bounds + (Dim + d) * boundsStride_;
+    }
+    ++inUse_;
+    return node;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicNodePool<Dim, Coord, Fanout>::release(Node* node) {
+    node->~Node();
+    *reinterpret_cast<void**>(node) = freeList_;
+    freeList_ = node;
+    --inUse_;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicNodePool<Dim, Coord, Fanout>::clear() {
+    for (char* slab : slabs_) ::operator delete(slab, std::align_val_t(kCacheLine));
+    slabs_.clear();
+    nextSlot_ = slotsPerSlab_;
+    freeList_ = nullptr;
+    inUse_ = 0;
+}
+
+
+//---------------------- RNode --------------------
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::pushEntry(const LeafEntryT &entry) {
+    points.push_back(entry.box.lower);
+    if (boxEntries) uppers.push_back(entry.box.upper);
+    ids.push_back(entry.id);
+    weights.push_back(entry.weight);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::eraseEntry(size_t i) {
+    points.erase(points.begin() + i);
+    if (boxEntries) uppers.erase(uppers.begin() + i);
+    ids.erase(ids.begin() + i);
+    weights.erase(weights.begin() + i);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicRNode<Dim, Coord, Fanout>* BasicRNode<Dim, Coord, Fanout>::insert(const LeafEntryT &entry) {
+    summary.count += 1;
+    summary.weightSum += entry.weight;
+    if (isLeaf) {
+        if (points.empty()) mbr = entry.box;
+        else mbr.expandToInclude(entry.box);
+        pushEntry(entry);
+
+        if (points.size() > Fanout) {
+            return linearSplitLeaf();
+        }
+        return nullptr;
+    } else {
+        Coord MAX = std::numeric_limits<Coord>::max();
+        BasicRNode* bestChild = nullptr;
+        for (BasicRNode* child : children) {
+            Coord delta = child->mbr.deltaSemiPerimeter(entry.box);
+            if (delta < MAX) {
+                MAX = delta;
+                bestChild = child;
+            }
+        }
+
+        BasicRNode* split = bestChild->insert(entry);
+        mbr.expandToInclude(entry.box);
+        setChildBounds(std::find(children.begin(), children.end(), bestChild) - children.begin());
+
+        if (split) {
+            children.push_back(split);
+            mbr.expandToInclude(split->mbr);
+            syncChildBounds();
+            if (children.size() > Fanout) {
+                return quadraticSplitInternal();
+            }
+        }
+        return nullptr;
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRNode<Dim, Coord, Fanout>::search(const MBBT &query) const -> std::vector<PointT> {
+    std::vector<PointT> result;
+    search(query, result);
+    return result;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::search(const MBBT &query, std::vector<PointT> &out, SearchStats* stats) const {
+    visit(query, [&out](const PointT &p) {
+        out.push_back(p);
+        return true;
+    }, stats);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::refreshMBR() {
+    summary = Aggregate();
+    if (isLeaf) {
+        if (points.empty()) mbr = MBBT();
+        else if (!boxEntries) mbr = MBBT::computeFromPoints(points);
+        else {
+            mbr = entryBox(0);
+            for (size_t i = 1; i < points.size(); ++i) mbr.expandToInclude(entryBox(i));
+        }
+        summary.count = points.size();
+        for (float w : weights) summary.weightSum += w;
+    } else {
+        if (!children.empty()) mbr = MBBT::computeFromNodes(children);
+        for (const BasicRNode* child : children) summary += child->summary;
+        syncChildBounds();
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::accumulate(const MBBT &query, Aggregate &total, SearchStats* stats) const {
+    if (stats) ++stats->nodesVisited;
+    if (isLeaf) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (!entryTouches(query, i)) continue;
+            total.count += 1;
+            total.weightSum += weights[i];
+        }
+        return;
+    }
+    uint64_t overlap[kMaskWords], inside[kMaskWords];
+    childMasks(query, overlap, inside);
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (maskBit(inside, i)) {
+            total += children[i]->summary;
+            if (stats) ++stats->nodesContained;
+        } else if (maskBit(overlap, i)) {
+            children[i]->accumulate(query, total, stats);
+        } else if (stats) {
+            ++stats->nodesPruned;
+        }
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::setChildBounds(size_t i) {
+    const MBBT &b = children[i]->mbr;
+    for (size_t d = 0; d < Dim; ++d) {
+        childLow[d][i] = b.lower[d];
+        childUp[d][i] = b.upper[d];
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::syncChildBounds() {
+    const size_t n = children.size();
+    for (size_t i = 0; i < n; ++i) setChildBounds(i);
+    // Relleno: cajas vacias que no tocan ninguna consulta
+    const Coord inf = std::numeric_limits<Coord>::infinity();
+    for (size_t i = n; i % 8 != 0; ++i) {
+        for (size_t d = 0; d < Dim; ++d) {
+            childLow[d][i] = inf;
+            childUp[d][i] = -inf;
+        }
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::childMasks(const MBBT &query, uint64_t* overlap, uint64_t* inside) const {
+    const size_t n = children.size();
+    for (size_t w = 0; w < kMaskWords; ++w) overlap[w] = inside[w] = 0;
+#if defined(RTREE_SIMD)
+    if constexpr (std::is_same<Coord, float>::value) {
+        __m256 ql[Dim], qu[Dim];
+        for (size_t d = 0; d < Dim; ++d) {
+            ql[d] = _mm256_set1_ps(query.lower[d]);
+            qu[d] = _mm256_set1_ps(query.upper[d]);
+        }
+        for (size_t i = 0; i < n; i += 8) {
+            __m256 ov, in;
+            for (size_t d = 0; d < Dim; ++d) {
+                __m256 lo = _mm256_load_ps(childLow[d] + i), up = _mm256_load_ps(childUp[d] + i);
+                __m256 ovd = _mm256_and_ps(_mm256_cmp_ps(lo, qu[d], _CMP_LE_OQ), _mm256_cmp_ps(ql[d], up, _CMP_LE_OQ));
+                __m256 ind = _mm256_and_ps(_mm256_cmp_ps(ql[d], lo, _CMP_LE_OQ), _mm256_cmp_ps(up, qu[d], _CMP_LE_OQ));
+                ov = d == 0 ? ovd : _mm256_and_ps(ov, ovd);
+                in = d == 0 ? ind : _mm256_and_ps(in, ind);
+            }
+            // i es multiplo de 8, asi que los 8 bits caben en una palabra
+            overlap[i / 64] |= static_cast<uint64_t>(_mm256_movemask_ps(ov)) << (i % 64);
+            inside[i / 64] |= static_cast<uint64_t>(_mm256_movemask_ps(in)) << (i % 64);
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        bool ov = true, in = true;
+        for (size_t d = 0; d < Dim; ++d) {
+            ov = ov && childLow[d][i] <= query.upper[d] && query.lower[d] <= childUp[d][i];
+            in = in && query.lower[d] <= childLow[d][i] && childUp[d][i] <= query.upper[d];
+        }
+        overlap[i / 64] |= static_cast<uint64_t>(ov) << (i % 64);
+        inside[i / 64] |= static_cast<uint64_t>(in) << (i % 64);
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::childDistances(const PointT &query, Coord* out) const {
+    const size_t n = children.size();
+#if defined(RTREE_SIMD)
+    if constexpr (std::is_same<Coord, float>::value) {
+        const __m256 zero = _mm256_setzero_ps();
+        for (size_t i = 0; i < n; i += 8) {
+            __m256 sum = zero;
+            for (size_t d = 0; d < Dim; ++d) {
+                const __m256 q = _mm256_set1_ps(query[d]);
+                __m256 delta = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(_mm256_load_ps(childLow[d] + i), q), zero),
+                                             _mm256_sub_ps(q, _mm256_load_ps(childUp[d] + i)));
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(delta, delta));
+            }
+            _mm256_storeu_ps(out + i, sum);
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        Coord sum = 0;
+        for (size_t d = 0; d < Dim; ++d) {
+            Coord delta = std::max({ childLow[d][i] - query[d], Coord(0), query[d] - childUp[d][i] });
+            sum += delta * delta;
+        }
+        out[i] = sum;
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRNode<Dim, Coord, Fanout>::leafEntries() const -> std::vector<LeafEntryT> {
+    std::vector<LeafEntryT> entries(points.size());
+    for (size_t i = 0; i < points.size(); ++i) entries[i] = { entryBox(i), ids[i], weights[i] };
+    return entries;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRNode<Dim, Coord, Fanout>::setLeafEntries(const std::vector<LeafEntryT> &entries) {
+    points.resize(entries.size());
+    if (boxEntries) uppers.resize(entries.size());
+    ids.resize(entries.size());
+    weights.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        points[i] = entries[i].box.lower;
+        if (boxEntries) uppers[i] = entries[i].box.upper;
+        ids[i] = entries[i].id;
+        weights[i] = entries[i].weight;
+    }
+}
+
+// --------------------- Splits clasicos --------------------
+// Compartidos con PagedRTree: reparten 'entries' (el nodo desbordado) en dos
+// grupos de al menos minEntries; box(e) da la caja de cada entrada.
+namespace rtree_detail {
+
+// Split lineal: semillas = par de centros mas lejano; cada entrada va con la
+// semilla mas cercana mientras el otro grupo todavia pueda llegar al minimo
+template <typename E, typename BoxOf>
+void linearSplit(const std::vector<E> &entries, size_t minEntries, BoxOf box, std::vector<E> &groupA, std::vector<E> &groupB) {
+    typedef typename std::decay<decltype(box(entries[0]))>::type Box;
+    typedef typename Box::PointT PointT;
+    typedef typename PointT::coord_type Coord;
+    const size_t Dim = PointT::dimensions;
+    std::vector<PointT> centers(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        const Box b = box(entries[i]);
+        for (size_t d = 0; d < Dim; ++d) centers[i][d] = (b.lower[d] + b.upper[d]) / 2;
+    }
+
+    size_t var1 = 0, var2 = 0;
+    Coord max_dist = -1;
+    for (size_t i = 0; i < centers.size(); i++) {
+        for (size_t j = i + 1; j < centers.size(); j++) {
+            Coord d = centers[i].distanceSquaredTo(centers[j]);
+            if (d > max_dist) {
+                max_dist = d;
+                var1 = i;
+                var2 = j;
+            }
+        }
+    }
+
+    const PointT a = centers[var1], b = centers[var2];
+    for (size_t i = 0; i < entries.size(); i++) {
+        Coord da = centers[i].distanceSquaredTo(a);
+        Coord db = centers[i].distanceSquaredTo(b);
+        if ((groupA.size() < minEntries && da < db) || groupB.size() >= minEntries)
+            groupA.push_back(entries[i]);
+        else
+            groupB.push_back(entries[i]);
+    }
+}
+
+// Split cuadratico: semillas = par que mas area desperdicia juntas; el resto
+// va al grupo cuyo MBB crece a menor area
+template <typename E, typename BoxOf>
+void quadraticSplit(const std::vector<E> &entries, size_t minEntries, BoxOf box, std::vector<E> &groupA, std::vector<E> &groupB) {
+    typedef typename std::decay<decltype(box(entries[0]))>::type Box;
+    typedef typename Box::PointT::coord_type Coord;
+    size_t var1 = 0, var2 = 0;
+    Coord max_perdida = -std::numeric_limits<Coord>::max();  // la perdida puede ser negativa si los MBBs se solapan
+    for (size_t i = 0; i < entries.size(); i++) {
+        for (size_t j = i + 1; j < entries.size(); j++) {
+            const Box bi = box(entries[i]), bj = box(entries[j]);
+            Coord perdida = Box::unionOf(bi, bj).area() - bi.area() - bj.area();
+            if (perdida > max_perdida) {
+                max_perdida = perdida;
+                var1 = i;
+                var2 = j;
+            }
+        }
+    }
+
+    groupA.push_back(entries[var1]);
+    groupB.push_back(entries[var2]);
+    Box boundsA = box(entries[var1]), boundsB = box(entries[var2]);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i == var1 || i == var2) continue;
+        const Box bi = box(entries[i]);
+        Coord d1 = Box::unionOf(boundsA, bi).area();
+        Coord d2 = Box::unionOf(boundsB, bi).area();
+        if ((groupA.size() < minEntries && d1 < d2) || groupB.size() >= minEntries) {
+            groupA.push_back(entries[i]);
+            boundsA.expandToInclude(bi);
+        } else {
+            groupB.push_back(entries[i]);
+            boundsB.expandToInclude(bi);
+        }
+    }
+}
+
+} // namespace rtree_detail
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicRNode<Dim, Coord, Fanout>* BasicRNode<Dim, Coord, Fanout>::linearSplitLeaf() {
+    // Se compara por el centro de cada caja (para puntos, el punto mismo)
+    std::vector<LeafEntryT> groupA, groupB;
+    rtree_detail::linearSplit(leafEntries(), (Fanout + 1) / 2, [](const LeafEntryT &e) { return e.box; }, groupA, groupB);
+
+    BasicRNode* newNode = pool->create(true);
+    setLeafEntries(groupA);
+    refreshMBR();
+    newNode->setLeafEntries(groupB);
+    newNode->refreshMBR();
+    return newNode;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicRNode<Dim, Coord, Fanout>* BasicRNode<Dim, Coord, Fanout>::quadraticSplitInternal() {
+    std::vector<BasicRNode*> groupA, groupB;
+    rtree_detail::quadraticSplit(std::vector<BasicRNode*>(children.begin(), children.end()), (Fanout + 1) / 2,
+                                 [](const BasicRNode* n) { return n->mbr; }, groupA, groupB);
+
+    BasicRNode* newNode = pool->create(false);
+    children.assign(groupA.begin(), groupA.end());
+    newNode->children.assign(groupB.begin(), groupB.end());
+    refreshMBR();
+    newNode->refreshMBR();
+    return newNode;
+}
+
+// --------------------- R* --------------------
+namespace rtree_detail {
+
+template <size_t Dim, typename Coord>
+const BasicMBB<Dim, Coord> &boxOf(const BasicLeafEntry<Dim, Coord> &e) { return e.box; }
+template <size_t Dim, typename Coord, size_t Fanout>
+const BasicMBB<Dim, Coord> &boxOf(const BasicRNode<Dim, Coord, Fanout>* n) { return n->mbr; }
+
+// Ordena 'entries' segun el split topologico de R* y devuelve cuantas van al
+// primer grupo. Cada grupo recibe al menos 'minEntries'.
+template <typename Box, typename E>
+size_t rstarDistribution(std::vector<E> &entries, size_t minEntries) {
+    typedef typename Box::PointT::coord_type Coord;
+    const size_t n = entries.size();
+    auto sortBy = [&](size_t axis, bool byHigh) {
+        std::sort(entries.begin(), entries.end(), [&](const E &a, const E &b) {
+            const Box &ba = boxOf(a), &bb = boxOf(b);
+            Coord ka = byHigh ? ba.upper[axis] : ba.lower[axis];
+            Coord kb = byHigh ? bb.upper[axis] : bb.lower[axis];
+            return ka < kb;
+        });
+    };
+    // prefix[k] = MBB de entries[0..k], suffix[k] = MBB de entries[k..n)
+    std::vector<Box> prefix(n), suffix(n);
+    auto sweep = [&]() {
+        prefix[0] = boxOf(entries[0]);
+        for (size_t i = 1; i < n; ++i) prefix[i] = Box::unionOf(prefix[i - 1], boxOf(entries[i]));
+        suffix[n - 1] = boxOf(entries[n - 1]);
+        for (size_t i = n - 1; i-- > 0;) suffix[i] = Box::unionOf(suffix[i + 1], boxOf(entries[i]));
+    };
+
+    // Eje: menor suma de margenes sobre todas las distribuciones
+    size_t bestAxis = 0;
+    Coord bestMargin = std::numeric_limits<Coord>::max();
+    for (size_t axis = 0; axis < Box::PointT::dimensions; ++axis) {
+        Coord margin = 0;
+        for (bool byHigh : {false, true}) {
+            sortBy(axis, byHigh);
+            sweep();
+            for (size_t k = minEntries; k + minEntries <= n; ++k)
+                margin += prefix[k - 1].semiPerimeter() + suffix[k].semiPerimeter();
+        }
+        if (margin < bestMargin) {
+            bestMargin = margin;
+            bestAxis = axis;
+        }
+    }
+
+    // Distribucion: menor solapamiento, luego menor area total
+    bool bestHigh = false;
+    size_t bestK = minEntries;
+    Coord bestOverlap = std::numeric_limits<Coord>::max(), bestArea = std::numeric_limits<Coord>::max();
+    for (bool byHigh : {false, true}) {
+        sortBy(bestAxis, byHigh);
+        sweep();
+        for (size_t k = minEntries; k + minEntries <= n; ++k) {
+            Coord overlap = prefix[k - 1].intersects(suffix[k]);
+            Coord area = prefix[k - 1].area() + suffix[k].area();
+            if (overlap < bestOverlap || (overlap == bestOverlap && area < bestArea)) {
+                bestOverlap = overlap;
+                bestArea = area;
+                bestHigh = byHigh;
+                bestK = k;
+            }
+        }
+    }
+    sortBy(bestAxis, bestHigh);
+    return bestK;
+}
+
+// Ordena por distancia (al cuadrado) del centro de cada entrada al centro de 'box', de mayor a menor
+template <typename Box, typename E>
+void sortFarthestFirst(std::vector<E> &entries, const Box &box) {
+    typedef typename Box::PointT::coord_type Coord;
+    const size_t Dim = Box::PointT::dimensions;
+    auto dist = [&](const E &e) {
+        const Box &b = boxOf(e);
+        Coord sum = 0;
+        for (size_t d = 0; d < Dim; ++d) {
+            Coord delta = (b.lower[d] + b.upper[d]) / 2 - (box.lower[d] + box.upper[d]) / 2;
+            sum += delta * delta;
+        }
+        return sum;
+    };
+    std::stable_sort(entries.begin(), entries.end(), [&](const E &a, const E &b) { return dist(a) > dist(b); });
+}
+
+} // namespace rtree_detail
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicRNode<Dim, Coord, Fanout>* BasicRNode<Dim, Coord, Fanout>::chooseSubtreeRStar(const MBBT &box) const {
+    const bool childrenAreLeaves = children[0]->isLeaf;
+    BasicRNode* best = nullptr;
+    Coord bestOverlap = std::numeric_limits<Coord>::max();
+    Coord bestEnlargement = std::numeric_limits<Coord>::max();
+    Coord bestArea = std::numeric_limits<Coord>::max();
+    for (BasicRNode* child : children) {
+        MBBT grown = MBBT::unionOf(child->mbr, box);
+        Coord enlargement = grown.area() - child->mbr.area();
+        Coord overlap = 0;
+        if (childrenAreLeaves) {
+            for (BasicRNode* other : children) {
+                if (other == child) continue;
+                overlap += grown.intersects(other->mbr) - child->mbr.intersects(other->mbr);
+            }
+        }
+        Coord area = child->mbr.area();
+        if (overlap < bestOverlap ||
+            (overlap == bestOverlap && (enlargement < bestEnlargement ||
+                                        (enlargement == bestEnlargement && area < bestArea)))) {
+            best = child;
+            bestOverlap = overlap;
+            bestEnlargement = enlargement;
+            bestArea = area;
+        }
+    }
+    return best;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+BasicRNode<Dim, Coord, Fanout>* BasicRNode<Dim, Coord, Fanout>::rstarSplit() {
+    size_t minEntries = (Fanout + 1) / 2;
+    BasicRNode* newNode = pool->create(isLeaf);
+    if (isLeaf) {
+        std::vector<LeafEntryT> entries = leafEntries();
+        size_t k = rtree_detail::rstarDistribution<MBBT>(entries, minEntries);
+        newNode->setLeafEntries(std::vector<LeafEntryT>(entries.begin() + k, entries.end()));
+        entries.resize(k);
+        setLeafEntries(entries);
+    } else {
+        std::vector<BasicRNode*> entries(children.begin(), children.end());
+        size_t k = rtree_detail::rstarDistribution<MBBT>(entries, minEntries);
+        newNode->children.assign(entries.begin() + k, entries.end());
+        children.assign(entries.begin(), entries.begin() + k);
+    }
+    refreshMBR();
+    newNode->refreshMBR();
+    return newNode;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRNode<Dim, Coord, Fanout>::takeFarthestPoints(size_t count) -> std::vector<LeafEntryT> {
+    std::vector<LeafEntryT> entries = leafEntries();
+    rtree_detail::sortFarthestFirst(entries, mbr);
+    std::vector<LeafEntryT> removed(entries.begin(), entries.begin() + count);
+    setLeafEntries(std::vector<LeafEntryT>(entries.begin() + count, entries.end()));
+    refreshMBR();
+    return removed;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRNode<Dim, Coord, Fanout>::takeFarthestChildren(size_t count) -> std::vector<BasicRNode*> {
+    std::vector<BasicRNode*> entries(children.begin(), children.end());
+    rtree_detail::sortFarthestFirst(entries, mbr);
+    std::vector<BasicRNode*> removed(entries.begin(), entries.begin() + count);
+    children.assign(entries.begin() + count, entries.end());
+    refreshMBR();
+    return removed;
+}
+
+// --------------------- STR --------------------
+namespace rtree_detail {
+
+// Cantidad de grupos para repartir n entradas con ocupacion objetivo 'fill',
+// respetando el minimo (maxEntries + 1) / 2 y el maximo maxEntries por grupo.
+inline size_t strGroupCount(size_t n, size_t maxEntries, float fill) {
+    size_t minEntries = (maxEntries + 1) / 2;
+    size_t target = static_cast<size_t>(fill * maxEntries);
+    target = std::max(minEntries, std::min<size_t>(maxEntries, target));
+    size_t fewest = (n + maxEntries - 1) / maxEntries;
+    size_t most = std::max<size_t>(1, n / minEntries);
+    size_t groups = (n + target - 1) / target;
+    return std::max(fewest, std::min(groups, most));
+}
+
+// Deja en su lugar los elementos de las posiciones cuts[lo..hi) (como si el
+// rango estuviera ordenado) con nth_element recursivo: O(n log k) en vez de
+// ordenar todo el rango.
+template <typename It, typename Cmp>
+void selectCuts(It first, const std::vector<size_t> &cuts, size_t lo, size_t hi, size_t begin, size_t end, Cmp cmp) {
+    if (lo >= hi) return;
+    size_t mid = (lo + hi) / 2;
+    size_t cut = cuts[mid];
+    if (cut > begin && cut < end) std::nth_element(first + begin, first + cut, first + end, cmp);
+    selectCuts(first, cuts, lo, mid, begin, cut, cmp);
+    selectCuts(first, cuts, mid + 1, hi, cut, end, cmp);
+}
+
+// Clave entera con el mismo orden que la coordenada, para radix: los
+// negativos invierten todos sus bits y los positivos solo el de signo
+inline uint32_t radixKey(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof bits);
+    return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+inline uint64_t radixKey(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof bits);
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+// Ordena [first, last) por keyOf(e) con radix LSD de 8 bits, usando 'scratch'
+// como buffer. Un digito igual en todo el rango (por ejemplo el exponente de
+// coordenadas parecidas) no se recorre.
+template <typename E, typename KeyOf>
+void radixSort(E* first, E* last, std::vector<E> &scratch, KeyOf keyOf) {
+    typedef decltype(radixKey(keyOf(*first))) U;
+    const size_t n = last - first;
+    if (scratch.size() < n) scratch.resize(n);
+    size_t count[sizeof(U)][256] = {};
+    for (E* it = first; it != last; ++it) {
+        U k = radixKey(keyOf(*it));
+        for (size_t d = 0; d < sizeof(U); ++d) ++count[d][(k >> (8 * d)) & 0xFF];
+    }
+    const U firstKey = radixKey(keyOf(*first));
+    E* src = first;
+    E* dst = scratch.data();
+    for (size_t d = 0; d < sizeof(U); ++d) {
+        if (count[d][(firstKey >> (8 * d)) & 0xFF] == n) continue;
+        size_t offset[256];
+        size_t sum = 0;
+        for (size_t b = 0; b < 256; ++b) {
+            offset[b] = sum;
+            sum += count[d][b];
+        }
+        for (size_t i = 0; i < n; ++i) dst[offset[(radixKey(keyOf(src[i])) >> (8 * d)) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+    if (src != first) std::copy(src, src + n, first);
+}
+
+// Deja en cada posicion de 'cuts' el elemento que tendria si [begin, end)
+// estuviera ordenado por key(., axis). Con coordenadas float o double el
+// rango se ordena entero con radix (unas pocas pasadas lineales); si no, o
+// si el rango es chico, con nth_element recursivo.
+template <typename E, typename Key>
+void placeCuts(std::vector<E> &items, const std::vector<size_t> &cuts, size_t begin, size_t end, size_t axis, Key key,
+               std::vector<E> &scratch) {
+    typedef typename std::decay<decltype(key(items[0], axis))>::type K;
+    if constexpr (std::is_same<K, float>::value || std::is_same<K, double>::value) {
+        if (end - begin >= 256) {
+            radixSort(items.data() + begin, items.data() + end, scratch, [&](const E &e) { return key(e, axis); });
+            return;
+        }
+    }
+    auto less = [&](const E &a, const E &b) { return key(a, axis) < key(b, axis); };
+    selectCuts(items.begin(), cuts, 0, cuts.size(), begin, end, less);
+}
+
+// Reparte los grupos [g0, g1) en S = ceil(k^(1/(Dim - axis))) franjas por la
+// coordenada 'axis' y cada franja recursivamente por los ejes siguientes (en
+// 2D: franjas verticales por x y dentro de cada una por y).
+template <size_t Dim, typename E, typename Key>
+void strTile(std::vector<E> &items, const std::vector<size_t> &bounds, size_t g0, size_t g1, size_t axis, Key key,
+             std::vector<E> &scratch) {
+    size_t groups = g1 - g0;
+    if (groups <= 1) return;
+    std::vector<size_t> cuts;
+    if (axis + 1 == Dim) {
+        cuts.assign(bounds.begin() + g0 + 1, bounds.begin() + g1);
+        placeCuts(items, cuts, bounds[g0], bounds[g1], axis, key, scratch);
+        return;
+    }
+    size_t slices = static_cast<size_t>(std::ceil(std::pow(static_cast<double>(groups), 1.0 / (Dim - axis)) - 1e-9));
+    std::vector<size_t> sliceBounds(slices + 1);
+    for (size_t s = 0; s <= slices; ++s) sliceBounds[s] = g0 + groups * s / slices;
+    for (size_t s = 1; s < slices; ++s) cuts.push_back(bounds[sliceBounds[s]]);
+    placeCuts(items, cuts, bounds[g0], bounds[g1], axis, key, scratch);
+    for (size_t s = 0; s < slices; ++s)
+        strTile<Dim>(items, bounds, sliceBounds[s], sliceBounds[s + 1], axis + 1, key, scratch);
+}
+
+// Reordena 'items' en teselas STR y devuelve los limites de 'groups' grupos
+// de tamanos casi iguales. Solo importa en que grupo queda cada elemento, no
+// el orden dentro del grupo. key(item, axis) da la coordenada a comparar.
+template <size_t Dim, typename E, typename Key>
+std::vector<size_t> strPack(std::vector<E> &items, size_t groups, Key key) {
+    size_t n = items.size();
+    std::vector<size_t> bounds(groups + 1);
+    for (size_t g = 0; g <= groups; ++g) bounds[g] = n * g / groups;
+    std::vector<E> scratch;
+    strTile<Dim>(items, bounds, 0, groups, 0, key, scratch);
+    return bounds;
+}
+
+template <typename P>
+bool samePoint(const P &a, const P &b) {
+    for (size_t d = 0; d < P::dimensions; ++d) {
+        if (a[d] != b[d]) return false;
+    }
+    return true;
+}
+
+template <typename Box>
+bool sameBox(const Box &a, const Box &b) {
+    return samePoint(a.lower, b.lower) && samePoint(a.upper, b.upper);
+}
+
+} // namespace rtree_detail
+
+// --------------------- RTree --------------------
+
+template <size_t Dim, typename Coord, size_t Fanout>
+EntryId BasicRTree<Dim, Coord, Fanout>::insert(const PointT &p) {
+    if (!positionsBuilt) {
+        // Sin indice todos los ids son menores que nextId (bulkLoad o ids
+        // automaticos), asi que el nuevo no puede repetirse
+        EntryId id = nextId++;
+        ++entryCount;
+        insertEntry({ MBBT(p, p), id, 0.0f });
+        return id;
+    }
+    while (positions.count(nextId)) ++nextId;
+    EntryId id = nextId++;
+    insert(p, id);
+    return id;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::insert(const PointT &p, EntryId id, float weight) {
+    insert(MBBT(p, p), id, weight);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::insert(const MBBT &box, EntryId id, float weight) {
+    assert(entryKind == BOX_ENTRIES || rtree_detail::samePoint(box.lower, box.upper));
+    buildPositions();
+    if (positions.count(id)) {
+        update(id, box);
+        return;
+    }
+    positions[id] = box;
+    ++entryCount;
+    insertEntry({ box, id, weight });
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::buildPositions() {
+    if (positionsBuilt) return;
+    positions.reserve(entryCount);
+    std::vector<const Node*> stack{root};
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        for (size_t i = 0; i < node->points.size(); ++i) positions[node->ids[i]] = node->entryBox(i);
+        stack.insert(stack.end(), node->children.begin(), node->children.end());
+    }
+    positionsBuilt = true;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::insertEntry(const LeafEntryT &entry) {
+    if (strategy == RSTAR_INSERT) {
+        std::vector<char> reinserted(height(), 0);
+        insertRStar(entry, nullptr, 0, reinserted);
+        return;
+    }
+    Node* split = root->insert(entry);
+    if (split) {
+        Node* newRoot = pool.create(false);
+        newRoot->children.push_back(root);
+        newRoot->children.push_back(split);
+        newRoot->refreshMBR();
+        root = newRoot;
+    }
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+bool BasicRTree<Dim, Coord, Fanout>::findLeaf(Node* node, const MBBT &box, EntryId id, std::vector<Node*> &path, size_t &index) {
+    if (!node->mbr.contains(box)) return false;
+    path.push_back(node);
+    if (node->isLeaf) {
+        for (size_t i = 0; i < node->points.size(); ++i) {
+            if (node->ids[i] == id && rtree_detail::sameBox(node->entryBox(i), box)) {
+                index = i;
+                return true;
+            }
+        }
+    } else {
+        for (Node* child : node->children) {
+            if (findLeaf(child, box, id, path, index)) return true;
+        }
+    }
+    path.pop_back();
+    return false;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::condenseTree(std::vector<Node*> &path) {
+    const size_t minEntries = (maxEntries + 1) / 2;
+    std::vector<LeafEntryT> orphans;
+    for (size_t i = path.size(); i-- > 1;) {
+        Node* node = path[i];
+        size_t count = node->isLeaf ? node->points.size() : node->children.size();
+        if (count >= minEntries) {
+            node->refreshMBR();
+            continue;
+        }
+        // Nodo con pocas entradas: se saca del padre y sus entradas quedan huerfanas
+        EntryArray<Node*> &siblings = path[i - 1]->children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+        std::vector<Node*> pending{node};
+        while (!pending.empty()) {
+            Node* n = pending.back();
+            pending.pop_back();
+            for (size_t j = 0; j < n->points.size(); ++j) orphans.push_back({ n->entryBox(j), n->ids[j], n->weights[j] });
+            pending.insert(pending.end(), n->children.begin(), n->children.end());
+            pool.release(n);
+        }
+    }
+    root->refreshMBR();
+
+    // Una raiz interna con un solo hijo se reemplaza por el hijo
+    while (!root->isLeaf && root->children.size() == 1) {
+        Node* child = root->children[0];
+        pool.release(root);
+        root = child;
+    }
+    if (!root->isLeaf && root->children.empty()) {
+        root->isLeaf = true;
+        root->refreshMBR();
+    }
+
+    for (const LeafEntryT &e : orphans) insertEntry(e);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+bool BasicRTree<Dim, Coord, Fanout>::remove(const PointT &p, EntryId id) {
+    return remove(MBBT(p, p), id);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+bool BasicRTree<Dim, Coord, Fanout>::remove(const MBBT &box, EntryId id) {
+    std::vector<Node*> path;
+    size_t index = 0;
+    if (!findLeaf(root, box, id, path, index)) return false;
+    path.back()->eraseEntry(index);
+    if (positionsBuilt) positions.erase(id);
+    --entryCount;
+    condenseTree(path);
+    return true;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+bool BasicRTree<Dim, Coord, Fanout>::update(EntryId id, const PointT &newPos) {
+    return update(id, MBBT(newPos, newPos));
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+bool BasicRTree<Dim, Coord, Fanout>::update(EntryId id, const MBBT &newBox) {
+    assert(entryKind == BOX_ENTRIES || rtree_detail::samePoint(newBox.lower, newBox.upper));
+    buildPositions();
+    auto it = positions.find(id);
+    if (it == positions.end()) return false;
+    const MBBT old = it->second;
+    std::vector<Node*> path;
+    size_t index = 0;
+    if (!findLeaf(root, old, id, path, index)) return false;
+    it->second = newBox;
+    Node* leaf = path.back();
+
+    // Movimiento pequeno: la hoja sigue cubriendo la entrada
+    if (leaf->mbr.contains(newBox)) {
+        leaf->points[index] = newBox.lower;
+        if (leaf->boxEntries) leaf->uppers[index] = newBox.upper;
+        // Los MBBs solo pueden encogerse, y solo si la entrada tocaba un borde
+        bool onBorder = false;
+        for (size_t d = 0; d < Dim; ++d) {
+            onBorder = onBorder || old.lower[d] == leaf->mbr.lower[d] || old.upper[d] == leaf->mbr.upper[d];
+        }
+        if (onBorder) {
+            for (size_t i = path.size(); i-- > 0;) path[i]->refreshMBR();
+        }
+        return true;
+    }
+
+    const float weight = leaf->weights[index];
+    leaf->eraseEntry(index);
+    condenseTree(path);
+    insertEntry({ newBox, id, weight });
+    return true;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRTree<Dim, Coord, Fanout>::search(const MBBT &query) const -> std::vector<PointT> {
+    return root->search(query);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::search(const MBBT &query, std::vector<PointT> &out, SearchStats* stats) const {
+    root->search(query, out, stats);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+bool BasicRTree<Dim, Coord, Fanout>::containsAny(const MBBT &query) const {
+    return !root->visit(query, [](const PointT &) { return false; });
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+Aggregate BasicRTree<Dim, Coord, Fanout>::aggregate(const MBBT &query, SearchStats* stats) const {
+    Aggregate total;
+    if (root->isLeaf && root->points.empty()) return total;
+    if (!root->mbr.overlaps(query)) {
+        if (stats) ++stats->nodesPruned;
+        return total;
+    }
+    if (query.contains(root->mbr)) {
+        if (stats) ++stats->nodesContained;
+        return root->summary;
+    }
+    root->accumulate(query, total, stats);
+    return total;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRTree<Dim, Coord, Fanout>::searchIds(const MBBT &query) const -> std::vector<EntryId> {
+    std::vector<EntryId> result;
+    searchIds(query, result);
+    return result;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::searchIds(const MBBT &query, std::vector<EntryId> &out, SearchStats* stats) const {
+    root->visitEntries(query, [&out](const Node &leaf, size_t i) {
+        out.push_back(leaf.ids[i]);
+        return true;
+    }, stats);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRTree<Dim, Coord, Fanout>::nearestEntries(const PointT &query, size_t k, Coord maxDist) const
+    -> std::vector<std::pair<const Node*, size_t>> {
+    typedef std::pair<const Node*, size_t> Item;
+    alignas(32) Coord childDist[Node::kChildSlots];
+    auto expand = [&](const Node* node, auto &offer, auto &push) {
+        if (node->isLeaf) {
+            for (size_t i = 0; i < node->points.size(); ++i) {
+                Coord dist = node->boxEntries ? node->entryBox(i).distanceSquaredTo(query)
+                                              : node->points[i].distanceSquaredTo(query);
+                offer(dist, Item(node, i));
+            }
+        } else {
+            node->childDistances(query, childDist);
+            for (size_t i = 0; i < node->children.size(); ++i) push(childDist[i], node->children[i]);
+        }
+    };
+    const Node* start = root;
+    return bestFirstKNN<Item>(start, root->mbr.distanceSquaredTo(query), k, entryCount, maxDist * maxDist, expand);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRTree<Dim, Coord, Fanout>::kNN(const PointT &query, size_t k, Coord maxDist) const -> std::vector<PointT> {
+    std::vector<PointT> result;
+    for (const auto &entry : nearestEntries(query, k, maxDist)) result.push_back(entry.first->points[entry.second]);
+    return result;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+auto BasicRTree<Dim, Coord, Fanout>::kNNIds(const PointT &query, size_t k, Coord maxDist) const -> std::vector<EntryId> {
+    std::vector<EntryId> result;
+    for (const auto &entry : nearestEntries(query, k, maxDist)) result.push_back(entry.first->ids[entry.second]);
+    return result;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::clear() {
+    pool.clear();
+    root = pool.create(true);
+    positions.clear();
+    positionsBuilt = true;
+    entryCount = 0;
+    nextId = 0;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::bulkLoad(std::vector<PointT> points, float fill, const std::vector<float> &weights) {
+    assert(weights.empty() || weights.size() == points.size());
+    // Los ids son las posiciones en 'points'
+    std::vector<LeafEntryT> entries(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        entries[i] = { MBBT(points[i], points[i]), i, weights.empty() ? 0.0f : weights[i] };
+    bulkLoadEntries(std::move(entries), fill);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::bulkLoad(const std::vector<MBBT> &boxes, float fill, const std::vector<float> &weights) {
+    assert(entryKind == BOX_ENTRIES);
+    assert(weights.empty() || weights.size() == boxes.size());
+    std::vector<LeafEntryT> entries(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) entries[i] = { boxes[i], i, weights.empty() ? 0.0f : weights[i] };
+    bulkLoadEntries(std::move(entries), fill);
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::bulkLoadEntries(std::vector<LeafEntryT> entries, float fill) {
+    clear();
+    // El indice de ids se arma recien si se usa (ver buildPositions)
+    positionsBuilt = false;
+    entryCount = entries.size();
+    nextId = entries.size();
+    if (entries.empty()) return;
+    if (entries.size() <= maxEntries) {
+        root->setLeafEntries(entries);
+        root->refreshMBR();
+        return;
+    }
+
+    // Hojas, por el centro de cada entrada. Se particionan claves compactas
+    // (centro por 2 e indice) en vez de las entradas: cada comparacion lee una
+    // clave ya calculada y los intercambios mueven la mitad de bytes. Las
+    // entradas se copian una sola vez, directo a su hoja.
+    struct Keyed {
+        Coord key[Dim];
+        size_t index;
+    };
+    std::vector<Keyed> keyed(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        for (size_t d = 0; d < Dim; ++d) keyed[i].key[d] = entries[i].box.lower[d] + entries[i].box.upper[d];
+        keyed[i].index = i;
+    }
+    size_t groups = rtree_detail::strGroupCount(entries.size(), maxEntries, fill);
+    std::vector<size_t> bounds = rtree_detail::strPack<Dim>(keyed, groups, [](const Keyed &k, size_t axis) { return k.key[axis]; });
+    std::vector<Node*> level;
+    level.reserve(groups);
+    for (size_t g = 0; g < groups; ++g) {
+        Node* leaf = pool.create(true);
+        for (size_t i = bounds[g]; i < bounds[g + 1]; ++i) leaf->pushEntry(entries[keyed[i].index]);
+        leaf->refreshMBR();
+        level.push_back(leaf);
+    }
+
+    // Niveles internos, de abajo hacia arriba, por el centro de cada MBB
+    auto center = [](const Node* n, size_t axis) { return n->mbr.lower[axis] + n->mbr.upper[axis]; };
+    while (level.size() > maxEntries) {
+        groups = rtree_detail::strGroupCount(level.size(), maxEntries, fill);
+        bounds = rtree_detail::strPack<Dim>(level, groups, center);
+        std::vector<Node*> parents;
+        parents.reserve(groups);
+        for (size_t g = 0; g < groups; ++g) {
+            Node* parent = pool.create(false);
+            parent->children.assign(level.begin() + bounds[g], level.begin() + bounds[g + 1]);
+            parent->refreshMBR();
+            parents.push_back(parent);
+        }
+        level.swap(parents);
+    }
+
+    root->isLeaf = false;
+    root->children.assign(level.begin(), level.end());
+    root->refreshMBR();
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+size_t BasicRTree<Dim, Coord, Fanout>::height() const {
+    size_t h = 1;
+    for (Node* node = root; !node->isLeaf; node = node->children[0]) ++h;
+    return h;
+}
+
+template <size_t Dim, typename Coord, size_t Fanout>
+void BasicRTree<Dim, Coord, Fanout>::insertRStar(const LeafEntryT &entry, Node* subtree, size_t level, std::vector<char> &reinserted) {
+    const size_t h = height();
+    MBBT box = subtree ? subtree->mbr : entry.box;
+
+    // Bajar hasta el nodo del nivel 'level' (las hojas son el nivel 0)
+    std::vector<Node*> path{root};
+    for (size_t l = h - 1; l > level; --l) path.push_back(path.back()->chooseSubtreeRStar(box));
+    if (subtree) {
+        path.back()->children.push_back(subtree);
+    } else {
+        path.back()->pushEntry(entry);
+    }
+
+    // Subir ajustando MBBs y tratando desbordes
+    for (size_t i = path.size(); i-- > 0;) {
+        Node* node = path[i];
+        size_t nodeLevel = h - 1 - i;
+        size_t count = node->isLeaf ? node->points.size() : node->children.size();
+        if (count <= maxEntries) {
+            node->refreshMBR();
+            continue;
+        }
+
+        // Primer desborde del nivel (salvo la raiz): reinsercion forzada del 30%
+        if (i > 0 && !reinserted[nodeLevel]) {
+            reinserted[nodeLevel] = 1;
+            size_t minEntries = (maxEntries + 1) / 2;
+            size_t take = std::min(std::max<size_t>(1, maxEntries * 3 / 10), count - minEntries);
+            std::vector<LeafEntryT> points;
+            std::vector<Node*> children;
+            if (node->isLeaf) points = node->takeFarthestPoints(take);
+            else children = node->takeFarthestChildren(take);
+            for (size_t j = i; j-- > 0;) path[j]->refreshMBR();
+
+            // Las mas cercanas al centro primero
+            for (size_t j = take; j-- > 0;) {
+                if (node->isLeaf) insertRStar(points[j], nullptr, nodeLevel, reinserted);
+                else insertRStar(LeafEntryT(), children[j], nodeLevel, reinserted);
+            }
+            return;
+        }
+
+        Node* sibling = node->rstarSplit();
+        if (i == 0) {
+            Node* newRoot = pool.create(false);
+            newRoot->children.push_back(root);
+            newRoot->children.push_back(sibling);
+            newRoot->refreshMBR();
+            root = newRoot;
+            reinserted.push_back(0);
+        } else {
+            path[i - 1]->children.push_back(sibling);
+        }
+    }
+}
+
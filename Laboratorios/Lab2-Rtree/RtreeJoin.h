@@ -0,0 +1,192 @@
+// Join espacial entre dos RTree: todos los pares (a, b), con a en el primer
+// arbol y b en el segundo, que cumplen un predicado.
+//
+// Ambos arboles se recorren a la vez: un par de nodos se descarta si sus MBBs
+// no pueden contener ningun par valido. Los pares de nodos de los primeros
+// niveles se reparten entre hilos (std::thread). sink(a, b) recibe dos
+// LeafEntry (caja, id y peso) y nunca se llama desde dos hilos a la vez; si
+// lanza, no se vuelve a llamar y spatialJoin relanza la excepcion.
+// Sirve igual para arboles de puntos y de cajas (EntryKind).
+//
+// Un predicado ofrece:
+//   boxes(A, B)  -> ¿el par de entradas (A, B) es valido? Para MBBs de nodos:
+//                   ¿puede haber un par valido entre sus entradas?
+//   widen(A)     -> caja que toca a todo B con boxes(A, B) (filtro con las
+//                   mascaras SoA de los hijos)
+#ifndef RTREE_JOIN_H
+#define RTREE_JOIN_H
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "Rtree.h"
+
+// Pares a distancia <= d
+template <size_t Dim, typename Coord>
+struct WithinDistance {
+    typedef BasicMBB<Dim, Coord> MBBT;
+
+    Coord d;
+
+    explicit WithinDistance(Coord d) : d(d) {}
+
+    bool boxes(const MBBT &a, const MBBT &b) const {
+        Coord sum = 0;
+        for (size_t i = 0; i < Dim; ++i) {
+            Coord gap = std::max({ a.lower[i] - b.upper[i], Coord(0), b.lower[i] - a.upper[i] });
+            sum += gap * gap;
+        }
+        return sum <= d * d;
+    }
+    MBBT widen(const MBBT &a) const {
+        MBBT result = a;
+        for (size_t i = 0; i < Dim; ++i) {
+            result.lower[i] -= d;
+            result.upper[i] += d;
+        }
+        return result;
+    }
+};
+
+// Pares cuyos MBBs se tocan (para puntos: coordenadas iguales)
+template <size_t Dim, typename Coord>
+struct Overlapping {
+    typedef BasicMBB<Dim, Coord> MBBT;
+
+    bool boxes(const MBBT &a, const MBBT &b) const { return a.overlaps(b); }
+    MBBT widen(const MBBT &a) const { return a; }
+};
+
+namespace rtree_detail {
+
+template <typename Node, typename Predicate, typename Emit>
+void joinNodes(const Node* a, const Node* b, const Predicate &pred, Emit &emit) {
+    typedef typename Node::MBBT MBBT;
+    uint64_t overlap[Node::kMaskWords], inside[Node::kMaskWords];
+    if (a->isLeaf && b->isLeaf) {
+        for (size_t i = 0; i < a->points.size(); ++i) {
+            const MBBT boxA = a->entryBox(i);
+            if (!pred.widen(boxA).overlaps(b->mbr)) continue;
+            for (size_t j = 0; j < b->points.size(); ++j) {
+                const MBBT boxB = b->entryBox(j);
+                if (pred.boxes(boxA, boxB)) emit({ boxA, a->ids[i], a->weights[i] }, { boxB, b->ids[j], b->weights[j] });
+            }
+        }
+    } else if (a->isLeaf || (!b->isLeaf && b->mbr.area() > a->mbr.area())) {
+        // Se baja por b: sus hijos se filtran de una pasada contra a ampliado
+        b->childMasks(pred.widen(a->mbr), overlap, inside);
+        for (size_t j = 0; j < b->children.size(); ++j) {
+            if (maskBit(overlap, j) && pred.boxes(a->mbr, b->children[j]->mbr))
+                joinNodes(a, b->children[j], pred, emit);
+        }
+    } else {
+        // Se baja por a; los hijos de a se comparan contra b completo
+        for (const Node* child : a->children) {
+            if (pred.boxes(child->mbr, b->mbr)) joinNodes(child, b, pred, emit);
+        }
+    }
+}
+
+} // namespace rtree_detail
+
+// Llama sink(a, b) por cada par valido y devuelve cuantos hubo. 'threads' = 0
+// usa std::thread::hardware_concurrency().
+template <size_t Dim, typename Coord, size_t Fanout, typename Predicate, typename Sink>
+size_t spatialJoin(const BasicRTree<Dim, Coord, Fanout> &a, const BasicRTree<Dim, Coord, Fanout> &b,
+                   const Predicate &pred, Sink &&sink, unsigned threads = 0) {
+    typedef BasicRNode<Dim, Coord, Fanout> Node;
+    typedef BasicLeafEntry<Dim, Coord> Entry;
+    typedef std::pair<const Node*, const Node*> Task;
+
+    const Node* rootA = a.root;
+    const Node* rootB = b.root;
+    if ((rootA->isLeaf && rootA->points.empty()) || (rootB->isLeaf && rootB->points.empty())) return 0;
+    if (!pred.boxes(rootA->mbr, rootB->mbr)) return 0;
+
+    unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // Pares de nodos de los primeros niveles: se expande el par mas alto hasta
+    // tener varias tareas por hilo
+    std::vector<Task> tasks{ Task(rootA, rootB) };
+    const size_t wanted = workers > 1 ? size_t(8) * workers : 1;
+    for (size_t round = 0; tasks.size() < wanted; ++round) {
+        std::vector<Task> next;
+        bool expanded = false;
+        for (const Task &t : tasks) {
+            if (t.first->isLeaf && t.second->isLeaf) {
+                next.push_back(t);
+                continue;
+            }
+            expanded = true;
+            if (t.first->isLeaf || (!t.second->isLeaf && round % 2 == 1)) {
+                for (const Node* child : t.second->children)
+                    if (pred.boxes(t.first->mbr, child->mbr)) next.push_back(Task(t.first, child));
+            } else {
+                for (const Node* child : t.first->children)
+                    if (pred.boxes(child->mbr, t.second->mbr)) next.push_back(Task(child, t.second));
+            }
+        }
+        tasks.swap(next);
+        if (!expanded) break;
+    }
+    workers = static_cast<unsigned>(std::min<size_t>(workers, std::max<size_t>(1, tasks.size())));
+
+    // Cada hilo junta pares en un buffer y lo vacia en 'sink' bajo el mutex.
+    // Si un hilo lanza (sink, pred o memoria) se guarda la primera excepcion,
+    // los demas dejan de tomar tareas y de llamar a sink, y se relanza despues
+    // de unir los hilos.
+    std::mutex sinkMutex;
+    std::atomic<size_t> nextTask(0);
+    std::atomic<size_t> total(0);
+    std::atomic<bool> stop(false);
+    std::exception_ptr error;
+    const size_t kFlush = 4096;
+    auto fail = [&]() {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        if (!error) error = std::current_exception();
+        stop = true;
+    };
+    auto work = [&]() {
+        try {
+            std::vector<std::pair<Entry, Entry>> buffer;
+            size_t found = 0;
+            auto flush = [&]() {
+                std::lock_guard<std::mutex> lock(sinkMutex);
+                if (!stop) {
+                    try {
+                        for (const auto &match : buffer) sink(match.first, match.second);
+                    } catch (...) {
+                        stop = true;  // antes de soltar el mutex: nadie mas llama a sink
+                        throw;
+                    }
+                }
+                buffer.clear();
+            };
+            auto emit = [&](const Entry &x, const Entry &y) {
+                buffer.push_back({ x, y });
+                ++found;
+                if (buffer.size() == kFlush) flush();
+            };
+            for (size_t t; !stop && (t = nextTask++) < tasks.size();) {
+                rtree_detail::joinNodes(tasks[t].first, tasks[t].second, pred, emit);
+            }
+            if (!buffer.empty()) flush();
+            total += found;
+        } catch (...) {
+            fail();
+        }
+    };
+    std::vector<std::thread> pool;
+    try {
+        for (unsigned w = 1; w < workers; ++w) pool.emplace_back(work);
+    } catch (...) {
+        fail();  // no se pudo crear un hilo: se corta y se relanza al final
+    }
+    work();
+    for (auto &t : pool) t.join();
+    if (error) std::rethrow_exception(error);
+    return total;
+}
+
+#endif // RTREE_JOIN_H
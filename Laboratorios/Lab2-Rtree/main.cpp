@@ -2,7 +2,11 @@
 #include <cmath>
 #include <ctime>
 #include <cassert>
+#include <cstdio>
 #include "Rtree.h"
+#include "RtreeJoin.h"
+#include "PagedRtree.h"
+#include "HilbertRtree.h"
 
 bool approxEqual(float a, float b, float epsilon = 1e-5f) {
     return std::fabs(a - b) < epsilon;
@@ -15,7 +19,8 @@ bool mbbEqual(const MBB &a, const MBB &b, float epsilon = 1e-5f) {
 }
 
 // Test: verifica las propiedades de R-tree
-bool checkTree(RNode* node, int maxEntries, bool isRoot, int currentDepth, int &leafDepth) {
+template <typename Node>
+bool checkTree(Node* node, int maxEntries, bool isRoot, int currentDepth, int &leafDepth) {
     bool ok = true;
     int minCapacity = (maxEntries + 1) / 2;
     
@@ -43,16 +48,16 @@ bool checkTree(RNode* node, int maxEntries, bool isRoot, int currentDepth, int &
             ok = false;
         }
 
-        // Comprobar que el MBB es mínimo: debe coincidir con el calculado a partir de los puntos.
+        // Comprobar que el MBB es mínimo: debe coincidir con el calculado a partir de las entradas.
         MBB computed;
         if (!node->points.empty()) {
-            computed.lower = node->points[0];
-            computed.upper = node->points[0];
+            computed = node->entryBox(0);
             for (size_t i = 1; i < node->points.size(); i++) {
-                computed.lower.x = std::min(computed.lower.x, node->points[i].x);
-                computed.lower.y = std::min(computed.lower.y, node->points[i].y);
-                computed.upper.x = std::max(computed.upper.x, node->points[i].x);
-                computed.upper.y = std::max(computed.upper.y, node->points[i].y);
+                MBB box = node->entryBox(i);
+                computed.lower.x = std::min(computed.lower.x, box.lower.x);
+                computed.lower.y = std::min(computed.lower.y, box.lower.y);
+                computed.upper.x = std::max(computed.upper.x, box.upper.x);
+                computed.upper.y = std::max(computed.upper.y, box.upper.y);
             }
         }
         if (!mbbEqual(node->mbr, computed)) {
@@ -120,7 +125,7 @@ bool checkTree(RNode* node, int maxEntries, bool isRoot, int currentDepth, int &
         }
 
         // Cada hijo debe tener su MBB contenido en el MBB del padre
-        for (RNode* child : node->children) {
+        for (Node* child : node->children) {
             if (!(node->mbr.lower.x <= child->mbr.lower.x &&
                   node->mbr.lower.y <= child->mbr.lower.y &&
                   node->mbr.upper.x >= child->mbr.upper.x &&
@@ -151,7 +156,8 @@ void testTreeStructure(RTree &tree) {
 
 
 // Test: Probar range query
-void testSearch(RTree &tree, const std::vector<Point> &allPoints) {
+template <typename Tree>
+void testSearch(Tree &tree, const std::vector<Point> &allPoints) {
     std::cout << "Ejecutando tests de búsqueda..." << std::endl;
 
     const int numQueries = 50;
@@ -242,14 +248,718 @@ void testKNN(RTree &tree, const std::vector<Point> &allPoints) {
     std::cout << "Pruebas de kNN completadas." << std::endl;
 }
 
+// Test: kNN con k grande y con distancia maxima
+void testKNNBounded(RTree &tree, const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de kNN acotado..." << std::endl;
+    for (int t = 0; t < 10; t++) {
+        Point query(static_cast<float>(std::rand() % 100), static_cast<float>(std::rand() % 100));
+        float radius = static_cast<float>(std::rand() % 15);
+        size_t k = 300 + std::rand() % 300;  // mas de 255
+
+        std::vector<float> naive;
+        for (const auto &pt : allPoints) naive.push_back(pt.distanceTo(query));
+        std::sort(naive.begin(), naive.end());
+
+        std::vector<Point> knn = tree.kNN(query, k);
+        if (knn.size() != std::min(k, naive.size()))
+            std::cerr << "Error en kNN acotado: se esperaban " << k << " puntos, pero se obtuvieron " << knn.size() << ".\n";
+        for (size_t i = 0; i < knn.size() && i < naive.size(); i++) {
+            if (!approxEqual(knn[i].distanceTo(query), naive[i])) {
+                std::cerr << "Error en kNN acotado: diferencia en el " << i << "-esimo vecino.\n";
+                break;
+            }
+        }
+
+        // Solo vecinos dentro del radio
+        size_t inside = std::upper_bound(naive.begin(), naive.end(), radius) - naive.begin();
+        std::vector<Point> near = tree.kNN(query, allPoints.size(), radius);
+        if (near.size() != inside)
+            std::cerr << "Error en kNN con radio " << radius << ": se esperaban " << inside
+                      << " puntos, pero se obtuvieron " << near.size() << ".\n";
+    }
+    if (!tree.kNN(Point(50.0f, 50.0f), 0).empty())
+        std::cerr << "Error en kNN: k = 0 debe devolver un resultado vacio.\n";
+    // Un k mayor que el arbol no reserva k entradas: devuelve todos los puntos
+    if (tree.kNN(Point(50.0f, 50.0f), std::numeric_limits<size_t>::max()).size() != allPoints.size())
+        std::cerr << "Error en kNN: k = SIZE_MAX deberia devolver los " << allPoints.size() << " puntos.\n";
+    std::cout << "Pruebas de kNN acotado completadas." << std::endl;
+}
 
 
 
+// Carga masiva con capacidad M: invariantes y contenido para varios tamanos y ocupaciones
+template <size_t M>
+void testBulkLoadFanout(const std::vector<Point> &allPoints) {
+    const int sizes[] = {0, 1, 11, 12, 23, 121, 500, (int)allPoints.size()};
+    const float fills[] = {0.5f, 0.7f, 1.0f};
+    for (float fill : fills) {
+        for (int n : sizes) {
+            std::vector<Point> pts(allPoints.begin(), allPoints.begin() + n);
+            BasicRTree<2, float, M> tree;
+            tree.bulkLoad(pts, fill);
+            int leafDepth = -1;
+            if (!checkTree(tree.root, tree.maxEntries, true, 0, leafDepth)) {
+                std::cerr << "ERROR: STR con M=" << M << ", fill=" << fill
+                          << ", n=" << n << " viola las invariantes." << std::endl;
+            }
+            MBB all(Point(-1.0f, -1.0f), Point(101.0f, 101.0f));
+            if (tree.search(all).size() != pts.size()) {
+                std::cerr << "Error en STR: se esperaban " << pts.size() << " puntos, pero se obtuvieron "
+                          << tree.search(all).size() << ".\n";
+            }
+        }
+    }
+}
 
+// Test: carga masiva STR con distintos tamanos y ocupaciones
+void testBulkLoad(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de carga masiva (STR)..." << std::endl;
+    testBulkLoadFanout<3>(allPoints);
+    testBulkLoadFanout<4>(allPoints);
+    testBulkLoadFanout<11>(allPoints);
+
+    RTree tree;
+    std::clock_t start = std::clock();
+    tree.bulkLoad(allPoints);
+    double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+    std::cout << "STR de " << allPoints.size() << " puntos: " << seconds * 1000.0 << " ms" << std::endl;
+    testTreeStructure(tree);
+    testSearch(tree, allPoints);
+    testKNN(tree, allPoints);
 
+    // Tras la carga el indice de ids se arma recien al usarlo: los ids
+    // automaticos siguen siendo nuevos y un id existente equivale a update
+    EntryId fresh = tree.insert(Point(50.5f, 50.5f));
+    if (fresh != allPoints.size() || tree.size() != allPoints.size() + 1)
+        std::cerr << "Error: id automatico " << fresh << " tras la carga masiva, size() = " << tree.size() << ".\n";
+    tree.insert(Point(0.5f, 0.5f), 3);
+    if (tree.size() != allPoints.size() + 1 || tree.searchIds(MBB(Point(0.5f, 0.5f), Point(0.5f, 0.5f))) != std::vector<EntryId>{3})
+        std::cerr << "Error: insertar un id existente tras la carga masiva deberia moverlo.\n";
+    if (!tree.remove(Point(50.5f, 50.5f), fresh) || tree.size() != allPoints.size())
+        std::cerr << "Error: remove tras la carga masiva.\n";
+    std::cout << "Pruebas de carga masiva completadas." << std::endl;
+}
 
 
 
+// Suma del area solapada entre hojas hermanas (menor = mejor calidad)
+template <typename Node>
+float leafOverlap(Node* node) {
+    if (node->isLeaf) return 0.0f;
+    float total = 0.0f;
+    for (size_t i = 0; i < node->children.size(); i++) {
+        total += leafOverlap(node->children[i]);
+        for (size_t j = i + 1; j < node->children.size(); j++)
+            total += node->children[i]->mbr.intersects(node->children[j]->mbr);
+    }
+    return total;
+}
+
+// Insercion clasica y R* con capacidad M sobre los mismos puntos
+template <size_t M>
+void testRStarFanout(const std::vector<Point> &skewed) {
+    BasicRTree<2, float, M> classic, rstar(RSTAR_INSERT);
+    for (const auto &pt : skewed) {
+        classic.insert(pt);
+        rstar.insert(pt);
+    }
+    int leafDepth = -1;
+    if (!checkTree(rstar.root, rstar.maxEntries, true, 0, leafDepth))
+        std::cerr << "ERROR: R* con M=" << M << " viola las invariantes." << std::endl;
+    float classicOverlap = leafOverlap(classic.root), rstarOverlap = leafOverlap(rstar.root);
+    std::cout << "M=" << M << ": solapamiento clasico " << classicOverlap << ", R* " << rstarOverlap << std::endl;
+    if (!(rstarOverlap < classicOverlap))
+        std::cerr << "ERROR: con M=" << M << " R* no reduce el solapamiento entre hojas." << std::endl;
+
+    // Consultas chicas sobre el grupo denso: R* debe visitar menos nodos
+    SearchStats classicStats, rstarStats;
+    std::vector<Point> out;
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            MBB query(Point(10.0f + i * 0.5f, 80.0f + j * 0.4f), Point(10.25f + i * 0.5f, 80.2f + j * 0.4f));
+            out.clear();
+            classic.search(query, out, &classicStats);
+            out.clear();
+            rstar.search(query, out, &rstarStats);
+        }
+    }
+    std::cout << "M=" << M << ": nodos visitados clasico " << classicStats.nodesVisited << ", R* "
+              << rstarStats.nodesVisited << std::endl;
+    if (!(rstarStats.nodesVisited < classicStats.nodesVisited))
+        std::cerr << "ERROR: con M=" << M << " R* no visita menos nodos que la insercion clasica." << std::endl;
+    testSearch(rstar, skewed);
+}
+
+// Test: insercion R* (datos uniformes y agrupados)
+void testRStarInsert(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de insercion R*..." << std::endl;
+
+    // Datos sesgados: casi todo en dos grupos pequenos
+    std::vector<Point> skewed;
+    for (size_t i = 0; i < allPoints.size(); i++) {
+        const Point &p = allPoints[i];
+        if (i % 3 == 0) skewed.push_back(p);
+        else skewed.push_back(Point(10.0f + p.x / 20.0f, 80.0f + p.y / 25.0f));
+    }
+
+    testRStarFanout<3>(skewed);
+    testRStarFanout<4>(skewed);
+    testRStarFanout<11>(skewed);
+
+    RTree tree(RSTAR_INSERT);
+    for (const auto &pt : allPoints) tree.insert(pt);
+    testTreeStructure(tree);
+    testSearch(tree, allPoints);
+    testKNN(tree, allPoints);
+    std::cout << "Pruebas de insercion R* completadas." << std::endl;
+}
+
+// Test: busqueda con buffer del llamador, visitor y corte temprano
+void testVisitorSearch(RTree &tree, const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de busqueda con visitor..." << std::endl;
+    std::vector<Point> buffer;
+    for (int i = 0; i < 50; i++) {
+        float x1 = static_cast<float>(std::rand() % 100);
+        float y1 = static_cast<float>(std::rand() % 100);
+        float x2 = static_cast<float>(std::rand() % 100);
+        float y2 = static_cast<float>(std::rand() % 100);
+        MBB query(Point(x1, y1), Point(x2, y2));
+
+        size_t expected = 0;
+        for (const auto &pt : allPoints) {
+            if (pt.x >= query.lower.x && pt.x <= query.upper.x &&
+                pt.y >= query.lower.y && pt.y <= query.upper.y)
+                expected++;
+        }
+
+        // El buffer se reutiliza y se agrega al final
+        size_t before = buffer.size();
+        tree.search(query, buffer);
+        if (buffer.size() - before != expected)
+            std::cerr << "Error en busqueda con buffer: se esperaban " << expected << " puntos, pero se obtuvieron "
+                      << buffer.size() - before << ".\n";
+
+        // Corte temprano: el visitor para en el tercer punto
+        size_t visited = 0;
+        bool completed = tree.search(query, [&visited](const Point &) { return ++visited < 3; });
+        if (visited != std::min<size_t>(expected, 3) || completed != (expected < 3))
+            std::cerr << "Error en corte temprano: visitados " << visited << " de " << expected << ".\n";
+
+        if (tree.containsAny(query) != (expected > 0))
+            std::cerr << "Error en containsAny para " << expected << " puntos esperados.\n";
+    }
+    std::cout << "Pruebas de busqueda con visitor completadas." << std::endl;
+}
+
+// Los limites SoA de cada nodo interno deben coincidir con los MBB de sus hijos
+template <typename Node>
+bool checkChildBounds(Node* node) {
+    if (node->isLeaf) return true;
+    bool ok = true;
+    for (size_t i = 0; i < node->children.size(); i++) {
+        const MBB &b = node->children[i]->mbr;
+        if (node->childLow[0][i] != b.lower.x || node->childLow[1][i] != b.lower.y ||
+            node->childUp[0][i] != b.upper.x || node->childUp[1][i] != b.upper.y) {
+            std::cerr << "Error: limites SoA desactualizados en el hijo " << i << ".\n";
+            ok = false;
+        }
+        if (!checkChildBounds(node->children[i])) ok = false;
+    }
+    return ok;
+}
+
+template <typename Node>
+int countNodes(Node* node) {
+    int total = 1;
+    for (Node* child : node->children) total += countNodes(child);
+    return total;
+}
+
+// Test: poda de subarboles y camino rapido de contencion total
+void testSearchPruning(RTree &tree, const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de poda en busqueda..." << std::endl;
+    const size_t totalNodes = countNodes(tree.root);
+    checkChildBounds(tree.root);
+
+    // Consulta pequena: la mayoria de los subarboles se descartan
+    SearchStats small;
+    std::vector<Point> result;
+    tree.search(MBB(Point(10.0f, 10.0f), Point(15.0f, 15.0f)), result, &small);
+    if (small.nodesPruned == 0 || small.nodesVisited >= totalNodes)
+        std::cerr << "Error en poda: visitados " << small.nodesVisited << " de " << totalNodes
+                  << " nodos, descartados " << small.nodesPruned << ".\n";
+
+    // Consulta que cubre todo: la raiz se emite completa
+    SearchStats all;
+    result.clear();
+    tree.search(MBB(Point(-1.0f, -1.0f), Point(101.0f, 101.0f)), result, &all);
+    if (result.size() != allPoints.size() || all.nodesContained != 1 || all.nodesPruned != 0)
+        std::cerr << "Error en contencion total: " << result.size() << " puntos, "
+                  << all.nodesContained << " subarboles contenidos.\n";
+
+    // Consulta de un punto que roza un borde: el roce cuenta
+    const Point &p = allPoints[0];
+    result.clear();
+    tree.search(MBB(p, p), result);
+    if (result.empty())
+        std::cerr << "Error en poda: una consulta degenerada sobre un punto no lo encontro.\n";
+
+    std::cout << "Nodos: " << totalNodes << ", consulta pequena visita " << small.nodesVisited
+              << " y descarta " << small.nodesPruned << std::endl;
+    std::cout << "Pruebas de poda completadas." << std::endl;
+}
+
+
+// Borrado y actualizacion con capacidad M y la estrategia dada
+template <size_t M>
+void testRemoveUpdateFanout(const std::vector<Point> &allPoints, InsertStrategy strategy) {
+    BasicRTree<2, float, M> tree(strategy);
+    std::vector<Point> current(allPoints.size());
+    std::vector<bool> alive(allPoints.size(), true);
+    for (size_t i = 0; i < allPoints.size(); i++) {
+        tree.insert(allPoints[i], static_cast<uint>(i));
+        current[i] = allPoints[i];
+    }
+
+    // Movimientos pequenos y grandes, y borrado de la mitad
+    for (size_t i = 0; i < allPoints.size(); i++) {
+        if (i % 2 == 0) {
+            if (!tree.remove(current[i], static_cast<uint>(i)))
+                std::cerr << "Error en remove: no se encontro el id " << i << ".\n";
+            alive[i] = false;
+        } else {
+            float step = (i % 3 == 0) ? 0.5f : 30.0f;
+            Point moved(std::fmod(current[i].x + step, 100.0f), current[i].y);
+            tree.update(static_cast<uint>(i), moved);
+            current[i] = moved;
+        }
+    }
+    if (tree.remove(Point(-5.0f, -5.0f), 1) || tree.update(0, Point(1.0f, 1.0f)))
+        std::cerr << "Error: remove/update de una entrada inexistente devolvio true.\n";
+
+    int leafDepth = -1;
+    if (!checkTree(tree.root, tree.maxEntries, true, 0, leafDepth))
+        std::cerr << "ERROR: remove/update con M=" << M << " viola las invariantes." << std::endl;
+
+    std::vector<Point> remaining;
+    for (size_t i = 0; i < current.size(); i++)
+        if (alive[i]) remaining.push_back(current[i]);
+    if (tree.size() != remaining.size())
+        std::cerr << "Error: size() = " << tree.size() << ", se esperaba " << remaining.size() << ".\n";
+    testSearch(tree, remaining);
+
+    checkChildBounds(tree.root);
+    if (tree.nodePool().nodesInUse() != (size_t)countNodes(tree.root))
+        std::cerr << "Error en el pool: " << tree.nodePool().nodesInUse() << " nodos en uso, "
+                  << countNodes(tree.root) << " en el arbol.\n";
+
+    // Vaciar el arbol por completo
+    for (size_t i = 0; i < current.size(); i++)
+        if (alive[i]) tree.remove(current[i], static_cast<uint>(i));
+    if (!tree.root->isLeaf || !tree.root->points.empty() || tree.nodePool().nodesInUse() != 1)
+        std::cerr << "Error: el arbol deberia quedar vacio.\n";
+
+    tree.insert(Point(1.0f, 2.0f));
+    tree.clear();
+    if (tree.size() != 0 || tree.nodePool().nodesInUse() != 1 || !tree.search(MBB(Point(0, 0), Point(5, 5))).empty())
+        std::cerr << "Error: clear() no vacio el arbol.\n";
+}
+
+// Test: borrado y actualizacion de puntos moviles
+void testRemoveUpdate(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de borrado y actualizacion..." << std::endl;
+    for (InsertStrategy strategy : {CLASSIC_INSERT, RSTAR_INSERT}) {
+        testRemoveUpdateFanout<3>(allPoints, strategy);
+        testRemoveUpdateFanout<11>(allPoints, strategy);
+    }
+    std::cout << "Pruebas de borrado y actualizacion completadas." << std::endl;
+}
+
+
+// Test: conteo y suma de pesos por rango desde los totales de cada nodo
+void testAggregate(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de conteo y agregados..." << std::endl;
+    std::vector<float> weights(allPoints.size());
+    for (size_t i = 0; i < weights.size(); i++) weights[i] = static_cast<float>(i % 7);
+
+    for (int mode = 0; mode < 3; mode++) {
+        RTree tree(mode == 1 ? RSTAR_INSERT : CLASSIC_INSERT);
+        if (mode == 2) tree.bulkLoad(allPoints, 1.0f, weights);
+        else for (size_t i = 0; i < allPoints.size(); i++) tree.insert(allPoints[i], static_cast<uint>(i), weights[i]);
+
+        // Quitar algunos puntos y mover otros (conservan su peso)
+        std::vector<Point> current = allPoints;
+        std::vector<bool> alive(allPoints.size(), true);
+        for (size_t i = 0; i < allPoints.size(); i += 5) {
+            tree.remove(current[i], static_cast<uint>(i));
+            alive[i] = false;
+        }
+        for (size_t i = 1; i < allPoints.size(); i += 5) {
+            current[i] = Point(std::fmod(current[i].x + 40.0f, 100.0f), current[i].y);
+            tree.update(static_cast<uint>(i), current[i]);
+        }
+        if (tree.root->summary.count != tree.size())
+            std::cerr << "Error: la raiz cuenta " << tree.root->summary.count << " puntos.\n";
+
+        for (int q = 0; q < 30; q++) {
+            float x = static_cast<float>(std::rand() % 100), y = static_cast<float>(std::rand() % 100);
+            MBB query(Point(x, y), Point(x + std::rand() % 50, y + std::rand() % 50));
+            Aggregate expected;
+            for (size_t i = 0; i < current.size(); i++) {
+                if (!alive[i] || !query.contains(current[i])) continue;
+                expected.count++;
+                expected.weightSum += weights[i];
+            }
+            SearchStats stats;
+            Aggregate got = tree.aggregate(query, &stats);
+            if (got.count != expected.count || got.weightSum != expected.weightSum || tree.count(query) != expected.count)
+                std::cerr << "Error en aggregate (modo " << mode << "): " << got.count << "/" << got.weightSum
+                          << ", se esperaba " << expected.count << "/" << expected.weightSum << ".\n";
+        }
+
+        SearchStats whole;
+        MBB everything(Point(-1, -1), Point(101, 101));
+        if (tree.aggregate(everything, &whole).count != tree.size() || whole.nodesVisited != 0)
+            std::cerr << "Error: una consulta que cubre todo deberia usar solo el total de la raiz.\n";
+    }
+    std::cout << "Pruebas de conteo y agregados completadas." << std::endl;
+}
+
+
+// Test: arbol de cajas (BOX_ENTRIES) con ids de 64 bits
+void testBoxEntries(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de entradas (MBB, id)..." << std::endl;
+    const EntryId base = EntryId(1) << 40;
+    std::vector<MBB> boxes(allPoints.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        Point p = allPoints[i];
+        boxes[i] = MBB(p, Point(p.x + std::rand() % 6, p.y + std::rand() % 6));
+    }
+
+    for (int mode = 0; mode < 3; mode++) {
+        RTree tree(mode == 1 ? RSTAR_INSERT : CLASSIC_INSERT, BOX_ENTRIES);
+        // Con carga masiva los ids son las posiciones; si no, base + i
+        const EntryId first = mode == 2 ? 0 : base;
+        if (mode == 2) tree.bulkLoad(boxes);
+        else for (size_t i = 0; i < boxes.size(); i++) tree.insert(boxes[i], base + i);
+
+        // Quitar algunas cajas y mover otras
+        std::vector<MBB> current = boxes;
+        std::vector<bool> alive(boxes.size(), true);
+        for (size_t i = 0; i < boxes.size(); i += 4) {
+            if (!tree.remove(current[i], first + i))
+                std::cerr << "Error en remove de caja (modo " << mode << "): no se encontro el id " << first + i << ".\n";
+            alive[i] = false;
+        }
+        for (size_t i = 1; i < boxes.size(); i += 4) {
+            float dx = (i % 3 == 0) ? 0.5f : 40.0f;
+            current[i] = MBB(Point(std::fmod(current[i].lower.x + dx, 100.0f), current[i].lower.y),
+                             Point(std::fmod(current[i].lower.x + dx, 100.0f) + 3, current[i].upper.y));
+            tree.update(first + i, current[i]);
+        }
+        int leafDepth = -1;
+        if (!checkTree(tree.root, tree.maxEntries, true, 0, leafDepth))
+            std::cerr << "ERROR: el arbol de cajas (modo " << mode << ") viola las invariantes." << std::endl;
+
+        for (int q = 0; q < 30; q++) {
+            float x = static_cast<float>(std::rand() % 100), y = static_cast<float>(std::rand() % 100);
+            MBB query(Point(x, y), Point(x + std::rand() % 20, y + std::rand() % 20));
+            std::vector<EntryId> expected;
+            for (size_t i = 0; i < current.size(); i++)
+                if (alive[i] && query.overlaps(current[i])) expected.push_back(first + i);
+            std::vector<EntryId> found = tree.searchIds(query);
+            std::sort(found.begin(), found.end());
+            if (found != expected || tree.count(query) != expected.size())
+                std::cerr << "Error en searchIds de cajas (modo " << mode << "): " << found.size()
+                          << " ids, se esperaban " << expected.size() << ".\n";
+        }
+
+        // kNN por distancia a la caja
+        Point center(50.0f, 50.0f);
+        std::vector<float> dists;
+        for (size_t i = 0; i < current.size(); i++)
+            if (alive[i]) dists.push_back(current[i].distanceSquaredTo(center));
+        std::sort(dists.begin(), dists.end());
+        std::vector<EntryId> nearest = tree.kNNIds(center, 10);
+        bool ok = nearest.size() == 10;
+        for (size_t k = 0; ok && k < nearest.size(); k++)
+            ok = current[nearest[k] - first].distanceSquaredTo(center) == dists[k];
+        if (!ok) std::cerr << "Error en kNNIds de cajas (modo " << mode << ").\n";
+    }
+
+    // En un arbol de puntos searchIds devuelve los ids de lo que encuentra search
+    RTree points;
+    for (size_t i = 0; i < allPoints.size(); i++) points.insert(allPoints[i], base + i);
+    MBB query(Point(20, 20), Point(45, 60));
+    std::vector<EntryId> ids = points.searchIds(query);
+    bool ok = ids.size() == points.search(query).size();
+    for (EntryId id : ids) ok = ok && id >= base && query.contains(allPoints[id - base]);
+    if (!ok) std::cerr << "Error: searchIds en un arbol de puntos no coincide con search.\n";
+    std::cout << "Pruebas de entradas (MBB, id) completadas." << std::endl;
+}
+
+
+// Test: join espacial contra fuerza bruta
+void testSpatialJoin(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de join espacial..." << std::endl;
+    std::vector<Point> other;
+    for (size_t i = 0; i < 1500; i++)
+        other.push_back(Point(static_cast<float>(std::rand() % 1000) / 10, static_cast<float>(std::rand() % 1000) / 10));
+    other.push_back(allPoints[0]);  // al menos un punto repetido entre ambos conjuntos
+
+    RTree a, b(RSTAR_INSERT);
+    a.bulkLoad(allPoints);
+    for (size_t i = 0; i < other.size(); i++) b.insert(other[i], static_cast<uint>(i));
+
+    const float d = 2.5f;
+    std::vector<std::pair<EntryId, EntryId>> expectedNear, expectedSame;
+    for (size_t i = 0; i < allPoints.size(); i++) {
+        for (size_t j = 0; j < other.size(); j++) {
+            float dist = allPoints[i].distanceSquaredTo(other[j]);
+            if (dist <= d * d) expectedNear.push_back({ i, j });
+            if (dist == 0) expectedSame.push_back({ i, j });
+        }
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        std::vector<std::pair<EntryId, EntryId>> found;
+        auto sink = [&](const LeafEntry &x, const LeafEntry &y) { found.push_back({ x.id, y.id }); };
+        size_t count = spatialJoin(a, b, WithinDistance<2, float>(d), sink, threads);
+        std::sort(found.begin(), found.end());
+        if (count != found.size() || found != expectedNear)
+            std::cerr << "Error en join por distancia con " << threads << " hilos: " << found.size()
+                      << " pares, se esperaban " << expectedNear.size() << ".\n";
+
+        found.clear();
+        spatialJoin(a, b, Overlapping<2, float>(), sink, threads);
+        std::sort(found.begin(), found.end());
+        if (found != expectedSame)
+            std::cerr << "Error en join por solapamiento con " << threads << " hilos.\n";
+
+        // Un sink que lanza corta el join: la excepcion llega al llamador y
+        // sink no se vuelve a llamar
+        size_t calls = 0;
+        bool thrown = false;
+        auto failing = [&](const LeafEntry &, const LeafEntry &) {
+            if (++calls == 10) throw std::runtime_error("sink lleno");
+        };
+        try {
+            spatialJoin(a, b, WithinDistance<2, float>(d), failing, threads);
+        } catch (const std::runtime_error &e) {
+            thrown = std::string(e.what()) == "sink lleno";
+        }
+        if (!thrown || calls != 10)
+            std::cerr << "Error: join con " << threads << " hilos y un sink que lanza (" << calls << " llamadas).\n";
+    }
+    std::cout << "Pruebas de join espacial completadas." << std::endl;
+}
+
+
+// Test: arbol paginado en disco con un buffer pool pequeno
+void testPagedRTree(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de RTree paginado..." << std::endl;
+    const std::string path = "rtree_test.pages";
+    for (size_t pageSize : {512, 4096}) {
+        {
+            PagedRTree tree(path, pageSize, 8, CREATE_NEW);
+            IOStats io;
+            for (size_t i = 0; i < allPoints.size(); i++) tree.insert(allPoints[i], i, &io);
+            if (tree.size() != allPoints.size() || io.pageRequests == 0)
+                std::cerr << "Error: insercion paginada (" << pageSize << " bytes).\n";
+            if (pageSize == 512 && (tree.height() < 2 || io.pageReads == 0))
+                std::cerr << "Error: con 8 marcos se esperaban lecturas del archivo.\n";
+        }
+
+        // Un tamano de pagina invalido se rechaza antes de truncar el archivo
+        bool rejected = false;
+        try {
+            PagedRTree invalid(path, 100, 8, CREATE_NEW);
+        } catch (const std::invalid_argument &) {
+            rejected = true;
+        }
+        if (!rejected) std::cerr << "Error: PagedRTree acepto paginas de 100 bytes.\n";
+
+        // Reabrir el archivo (el modo por defecto no lo trunca) y consultar contra fuerza bruta
+        PagedRTree tree(path, pageSize, 8);
+        if (tree.size() != allPoints.size())
+            std::cerr << "Error: el arbol reabierto tiene " << tree.size() << " puntos.\n";
+        for (int q = 0; q < 20; q++) {
+            float x = static_cast<float>(std::rand() % 100), y = static_cast<float>(std::rand() % 100);
+            MBB query(Point(x, y), Point(x + std::rand() % 30, y + std::rand() % 30));
+            size_t expected = 0;
+            for (const Point &p : allPoints) expected += query.contains(p);
+            IOStats io;
+            std::vector<Point> found;
+            tree.search(query, found, &io);
+            if (found.size() != expected)
+                std::cerr << "Error en search paginado: " << found.size() << " en vez de " << expected << ".\n";
+            if (io.pageRequests != io.bufferHits + io.pageReads)
+                std::cerr << "Error en los contadores de E/S.\n";
+
+            Point center(x, y);
+            std::vector<float> dists;
+            for (const Point &p : allPoints) dists.push_back(p.distanceSquaredTo(center));
+            std::sort(dists.begin(), dists.end());
+            std::vector<Point> nearest = tree.kNN(center, 10);
+            if (nearest.size() != 10 || nearest.back().distanceSquaredTo(center) != dists[9])
+                std::cerr << "Error en kNN paginado.\n";
+        }
+        if (tree.kNN(Point(50.0f, 50.0f), std::numeric_limits<size_t>::max()).size() != allPoints.size())
+            std::cerr << "Error: kNN paginado con k = SIZE_MAX.\n";
+    }
+    std::remove(path.c_str());
+    std::cout << "Pruebas de RTree paginado completadas." << std::endl;
+}
+
+
+// Invariantes del Hilbert R-tree: claves ordenadas entre hojas, LHV correcto,
+// hojas a la misma profundidad y MBBs que cubren su contenido
+bool checkHilbertNode(const HilbertNode* node, size_t maxEntries, int depth, int &leafDepth, uint64_t &lastKey) {
+    if (node->count() > maxEntries) {
+        std::cerr << "Error: nodo Hilbert con " << node->count() << " entradas.\n";
+        return false;
+    }
+    if (node->isLeaf) {
+        if (leafDepth == -1) leafDepth = depth;
+        bool ok = leafDepth == depth;
+        for (const HilbertEntry &e : node->entries) {
+            ok = ok && e.key >= lastKey && node->mbr.contains(e.pt);
+            lastKey = e.key;
+        }
+        if (!node->entries.empty()) ok = ok && node->lhv == node->entries.back().key;
+        if (!ok) std::cerr << "Error: hoja Hilbert invalida.\n";
+        return ok;
+    }
+    bool ok = node->lhv == node->children.back()->lhv;
+    for (const HilbertNode* child : node->children) {
+        ok = ok && node->mbr.contains(child->mbr);
+        ok = checkHilbertNode(child, maxEntries, depth + 1, leafDepth, lastKey) && ok;
+    }
+    return ok;
+}
+
+int countLeaves(RNode* node) {
+    if (node->isLeaf) return 1;
+    int total = 0;
+    for (RNode* child : node->children) total += countLeaves(child);
+    return total;
+}
+
+// Test: Hilbert R-tree contra fuerza bruta y ocupacion de hojas
+void testHilbertRTree(const std::vector<Point> &allPoints) {
+    std::cout << "Ejecutando tests de Hilbert R-tree..." << std::endl;
+    const MBB world(Point(0, 0), Point(100, 100));
+    for (int mode = 0; mode < 2; mode++) {
+        HilbertRTree tree(world, 11);
+        if (mode == 0) for (const Point &p : allPoints) tree.insert(p);
+        else tree.bulkLoad(allPoints);
+
+        int leafDepth = -1;
+        uint64_t lastKey = 0;
+        if (!checkHilbertNode(tree.root, tree.maxEntries, 0, leafDepth, lastKey) || tree.size() != allPoints.size())
+            std::cerr << "ERROR: Hilbert R-tree (modo " << mode << ") viola las invariantes." << std::endl;
+
+        for (int q = 0; q < 20; q++) {
+            float x = static_cast<float>(std::rand() % 100), y = static_cast<float>(std::rand() % 100);
+            MBB query(Point(x, y), Point(x + std::rand() % 30, y + std::rand() % 30));
+            size_t expected = 0;
+            for (const Point &p : allPoints) expected += query.contains(p);
+            if (tree.search(query).size() != expected)
+                std::cerr << "Error en search del Hilbert R-tree (modo " << mode << ").\n";
+
+            Point center(x, y);
+            std::vector<float> dists;
+            for (const Point &p : allPoints) dists.push_back(p.distanceSquaredTo(center));
+            std::sort(dists.begin(), dists.end());
+            std::vector<Point> nearest = tree.kNN(center, 5);
+            if (nearest.size() != 5 || nearest.back().distanceSquaredTo(center) != dists[4])
+                std::cerr << "Error en kNN del Hilbert R-tree (modo " << mode << ").\n";
+        }
+
+        if (mode == 0) {
+            // Con split 2 a 3 las hojas quedan mas llenas que con el split clasico
+            RTree classic;
+            for (const Point &p : allPoints) classic.insert(p);
+            double classicUse = static_cast<double>(allPoints.size()) / (countLeaves(classic.root) * static_cast<double>(RTree::maxEntries));
+            if (tree.leafUtilization() < 0.66 || tree.leafUtilization() <= classicUse)
+                std::cerr << "Error: ocupacion de hojas Hilbert " << tree.leafUtilization()
+                          << " (clasico " << classicUse << ").\n";
+        } else if (tree.leafUtilization() < 0.99) {
+            std::cerr << "Error: la carga masiva deberia llenar las hojas.\n";
+        }
+        if (tree.kNN(Point(50.0f, 50.0f), std::numeric_limits<size_t>::max()).size() != allPoints.size())
+            std::cerr << "Error: kNN del Hilbert R-tree con k = SIZE_MAX (modo " << mode << ").\n";
+    }
+
+    // Ids de 64 bits: los automaticos siguen al mayor id dado
+    HilbertRTree wide(world, 11);
+    const EntryId big = EntryId(1) << 40;
+    wide.insert(Point(1.0f, 1.0f), big);
+    if (wide.insert(Point(2.0f, 2.0f)) != big + 1)
+        std::cerr << "Error: el Hilbert R-tree trunco un id de 64 bits.\n";
+    std::cout << "Pruebas de Hilbert R-tree completadas." << std::endl;
+}
+
+
+// Test: pasarse de la capacidad de un EntryArray lanza en vez de escribir fuera del bloque
+void testEntryArrayBounds() {
+    std::cout << "Ejecutando tests de capacidad de EntryArray..." << std::endl;
+    EntryId storage[3];
+    EntryArray<EntryId> ids;
+    ids.bind(storage, 2);
+    ids.push_back(1);
+    ids.push_back(2);
+    bool pushThrew = false, resizeThrew = false;
+    try { ids.push_back(3); } catch (const std::length_error &) { pushThrew = true; }
+    try { ids.resize(3); } catch (const std::length_error &) { resizeThrew = true; }
+    if (!pushThrew || !resizeThrew || ids.size() != 2)
+        std::cerr << "Error: EntryArray deberia rechazar entradas por encima de su capacidad.\n";
+    std::cout << "Pruebas de capacidad de EntryArray completadas." << std::endl;
+}
+
+
+// Test: otras dimensiones y tipos de coordenada contra fuerza bruta
+template <typename Tree>
+void testOtherInstance(const char* name) {
+    typedef typename Tree::PointT P;
+    typedef typename Tree::MBBT Box;
+    typedef typename P::coord_type Coord;
+    const size_t Dim = Tree::dimensions;
+    std::cout << "Ejecutando tests de " << name << "..." << std::endl;
+
+    std::vector<P> pts(1500);
+    for (P &p : pts)
+        for (size_t d = 0; d < Dim; d++) p[d] = static_cast<Coord>(std::rand() % 1000) / 10;
+
+    for (int mode = 0; mode < 3; mode++) {
+        Tree tree(mode == 1 ? RSTAR_INSERT : CLASSIC_INSERT);
+        if (mode == 2) tree.bulkLoad(pts);
+        else for (const P &p : pts) tree.insert(p);
+
+        for (int q = 0; q < 20; q++) {
+            P lo, hi;
+            for (size_t d = 0; d < Dim; d++) {
+                lo[d] = static_cast<Coord>(std::rand() % 100);
+                hi[d] = lo[d] + static_cast<Coord>(std::rand() % 40);
+            }
+            Box query(lo, hi);
+            size_t expected = 0;
+            for (const P &p : pts) expected += query.contains(p);
+            if (tree.search(query).size() != expected)
+                std::cerr << "Error en search de " << name << " (modo " << mode << ").\n";
+
+            const size_t k = 7;
+            std::vector<Coord> dists;
+            for (const P &p : pts) dists.push_back(p.distanceSquaredTo(lo));
+            std::sort(dists.begin(), dists.end());
+            std::vector<P> nearest = tree.kNN(lo, k);
+            if (nearest.size() != k || nearest.back().distanceSquaredTo(lo) != dists[k - 1])
+                std::cerr << "Error en kNN de " << name << " (modo " << mode << ").\n";
+        }
+    }
+    std::cout << "Pruebas de " << name << " completadas." << std::endl;
+}
+
 
 int main() {
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
@@ -261,15 +971,28 @@ int main() {
         allPoints.push_back(Point(x, y));
     }
 
-    int maxEntries = 11;
-    RTree tree(maxEntries);
+    RTree tree;
     for (const auto &pt : allPoints) {
         tree.insert(pt);
     }
 
     testTreeStructure(tree);
     testSearch(tree, allPoints);
+    testVisitorSearch(tree, allPoints);
+    testSearchPruning(tree, allPoints);
     testKNN(tree, allPoints);
+    testKNNBounded(tree, allPoints);
+    testBulkLoad(allPoints);
+    testRStarInsert(allPoints);
+    testRemoveUpdate(allPoints);
+    testAggregate(allPoints);
+    testBoxEntries(allPoints);
+    testSpatialJoin(allPoints);
+    testPagedRTree(allPoints);
+    testHilbertRTree(allPoints);
+    testOtherInstance<BasicRTree<3, float, 8>>("RTree 3D");
+    testOtherInstance<BasicRTree<2, double, 8>>("RTree double");
+    testEntryArrayBounds();
 
     std::cout << "\nTodos los tests avanzados completados." << std::endl;
 
@@ -0,0 +1,414 @@
+// Benchmark de RTree y HilbertRTree: insercion, carga masiva y consultas sobre
+// distintas distribuciones de puntos (main.cpp solo usa rand() % 100, una
+// rejilla chica con muchos repetidos).
+//
+// Distribuciones (en [0, 1000]^2):
+//   uniform   puntos uniformes
+//   gaussian  16 cumulos gaussianos
+//   zipf      celdas de una rejilla 64 x 64 elegidas con Zipf (s = 1)
+//   line      puntos sobre una recta con un ruido minimo (MBBs casi planos)
+//
+// Recorre tamanos (10k, 100k, ... hasta --max), maxEntries (--fanouts; el
+// RTree se instancia para 4, 8, 16, 32, 64, 128 y 255) y politicas (--policies):
+//   classic   RTree con CLASSIC_INSERT (split lineal/cuadratico)
+//   rstar     RTree con RSTAR_INSERT
+//   str       RTree::bulkLoad (Sort-Tile-Recursive)
+//   hilbert   HilbertRTree con inserciones (split diferido 2 a 3)
+// Para cada caso mide insercion (puntos/s) o carga masiva (ms), latencia
+// p50/p99 de consultas por rango para cada selectividad (fraccion del area)
+// y de kNN para cada k. Los resultados se escriben en CSV y/o JSON, una fila
+// por operacion.
+//
+// Compilar (sin sistema de build en este laboratorio):
+//   g++ -std=c++17 -O2 -DNDEBUG -mavx2 -pthread rtree_bench.cpp HilbertRtree.cpp -o rtree_bench
+// Uso: rtree_bench [--min N] [--max N] [--fanouts 8,16,...] [--policies classic,rstar,str,hilbert]
+//                  [--dists uniform,gaussian,zipf,line] [--queries Q] [--insert-max N]
+//                  [--csv archivo] [--json archivo]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Rtree.h"
+#include "HilbertRtree.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const float kSide = 1000.0f;
+
+// -------------------------------
+// Datos
+// -------------------------------
+std::vector<Point> uniformPoints(size_t n, std::mt19937 &gen) {
+    std::uniform_real_distribution<float> coord(0.0f, kSide);
+    std::vector<Point> points(n);
+    for (Point &p : points) p = Point(coord(gen), coord(gen));
+    return points;
+}
+
+std::vector<Point> gaussianPoints(size_t n, std::mt19937 &gen) {
+    std::uniform_real_distribution<float> coord(0.1f * kSide, 0.9f * kSide);
+    std::vector<Point> centers(16);
+    for (Point &c : centers) c = Point(coord(gen), coord(gen));
+    std::uniform_int_distribution<size_t> pick(0, centers.size() - 1);
+    std::normal_distribution<float> spread(0.0f, kSide / 50.0f);
+    std::vector<Point> points(n);
+    for (Point &p : points) {
+        const Point &c = centers[pick(gen)];
+        p = Point(std::min(kSide, std::max(0.0f, c.x + spread(gen))), std::min(kSide, std::max(0.0f, c.y + spread(gen))));
+    }
+    return points;
+}
+
+// Rango de la celda con probabilidad ~ 1 / rango; los rangos se asignan a
+// celdas al azar para que las celdas densas no queden juntas
+std::vector<Point> zipfPoints(size_t n, std::mt19937 &gen) {
+    const size_t cellsPerAxis = 64, cells = cellsPerAxis * cellsPerAxis;
+    std::vector<double> cdf(cells);
+    double sum = 0.0;
+    for (size_t r = 0; r < cells; ++r) cdf[r] = sum += 1.0 / static_cast<double>(r + 1);
+    std::vector<size_t> cellOfRank(cells);
+    for (size_t r = 0; r < cells; ++r) cellOfRank[r] = r;
+    std::shuffle(cellOfRank.begin(), cellOfRank.end(), gen);
+
+    std::uniform_real_distribution<double> u(0.0, sum);
+    std::uniform_real_distribution<float> inCell(0.0f, kSide / cellsPerAxis);
+    std::vector<Point> points(n);
+    for (Point &p : points) {
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(), u(gen)) - cdf.begin();
+        size_t cell = cellOfRank[std::min(rank, cells - 1)];
+        p = Point(static_cast<float>(cell % cellsPerAxis) * (kSide / cellsPerAxis) + inCell(gen),
+                  static_cast<float>(cell / cellsPerAxis) * (kSide / cellsPerAxis) + inCell(gen));
+    }
+    return points;
+}
+
+std::vector<Point> linePoints(size_t n, std::mt19937 &gen) {
+    std::uniform_real_distribution<float> t(0.0f, kSide);
+    std::normal_distribution<float> noise(0.0f, kSide * 1e-4f);
+    std::vector<Point> points(n);
+    for (Point &p : points) {
+        float x = t(gen);
+        p = Point(x, 0.1f * kSide + 0.6f * x + noise(gen));
+    }
+    return points;
+}
+
+std::vector<Point> makeInput(const std::string &dist, size_t n, std::mt19937 &gen) {
+    if (dist == "gaussian") return gaussianPoints(n, gen);
+    if (dist == "zipf") return zipfPoints(n, gen);
+    if (dist == "line") return linePoints(n, gen);
+    return uniformPoints(n, gen);
+}
+
+MBB boundsOf(const std::vector<Point> &points) {
+    MBB box(points[0], points[0]);
+    for (const Point &p : points) box.expandToInclude(p);
+    return box;
+}
+
+// -------------------------------
+// Medicion
+// -------------------------------
+double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    size_t idx = std::min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())));
+    return v[idx];
+}
+
+double microsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Una fila de resultados: una operacion sobre un arbol ya construido
+struct Result {
+    std::string distribution;
+    size_t points = 0;
+    std::string policy;
+    size_t maxEntries = 0;
+    std::string operation;  // insert, bulk_load, range, knn
+    double param = 0.0;     // selectividad (range) o k (knn)
+    size_t count = 0;       // operaciones medidas
+    double totalMs = 0.0;
+    double throughput = 0.0;  // operaciones por segundo
+    double p50 = 0.0, p99 = 0.0;  // us por operacion
+    double avgResults = 0.0;
+    double avgNodesVisited = 0.0;  // solo range
+};
+
+struct Workload {
+    std::vector<double> selectivities;
+    std::vector<size_t> ks;
+    std::vector<Point> centers;  // centros de las consultas: puntos de los datos
+};
+
+template <typename Tree>
+void runQueries(const Tree &tree, const Workload &work, const Result &base, std::vector<Result> &out) {
+    std::vector<double> latencies;
+    std::vector<Point> found;
+    for (double sel : work.selectivities) {
+        const float half = 0.5f * kSide * static_cast<float>(std::sqrt(sel));
+        Result r = base;
+        r.operation = "range";
+        r.param = sel;
+        size_t hits = 0, visited = 0;
+        latencies.clear();
+        for (const Point &c : work.centers) {
+            MBB query(Point(c.x - half, c.y - half), Point(c.x + half, c.y + half));
+            SearchStats stats;
+            found.clear();
+            auto t0 = Clock::now();
+            tree.search(query, found, &stats);
+            latencies.push_back(microsSince(t0));
+            hits += found.size();
+            visited += stats.nodesVisited;
+        }
+        r.count = latencies.size();
+        for (double l : latencies) r.totalMs += l / 1000.0;
+        r.throughput = r.totalMs > 0 ? 1000.0 * r.count / r.totalMs : 0.0;
+        r.p50 = percentile(latencies, 0.50);
+        r.p99 = percentile(latencies, 0.99);
+        r.avgResults = r.count ? static_cast<double>(hits) / r.count : 0.0;
+        r.avgNodesVisited = r.count ? static_cast<double>(visited) / r.count : 0.0;
+        out.push_back(r);
+    }
+    for (size_t k : work.ks) {
+        Result r = base;
+        r.operation = "knn";
+        r.param = static_cast<double>(k);
+        size_t hits = 0;
+        latencies.clear();
+        for (const Point &c : work.centers) {
+            auto t0 = Clock::now();
+            std::vector<Point> nearest = tree.kNN(c, k);
+            latencies.push_back(microsSince(t0));
+            hits += nearest.size();
+        }
+        r.count = latencies.size();
+        for (double l : latencies) r.totalMs += l / 1000.0;
+        r.throughput = r.totalMs > 0 ? 1000.0 * r.count / r.totalMs : 0.0;
+        r.p50 = percentile(latencies, 0.50);
+        r.p99 = percentile(latencies, 0.99);
+        r.avgResults = r.count ? static_cast<double>(hits) / r.count : 0.0;
+        out.push_back(r);
+    }
+}
+
+// RTree con M = Fanout: construye con 'policy' y mide consultas
+template <size_t Fanout>
+void runRTreeCase(const std::vector<Point> &points, const Workload &work, const Result &base, std::vector<Result> &out) {
+    Result build = base;
+    const size_t n = points.size();
+    BasicRTree<2, float, Fanout> tree(base.policy == "rstar" ? RSTAR_INSERT : CLASSIC_INSERT);
+    auto start = Clock::now();
+    if (base.policy == "str") {
+        tree.bulkLoad(points);
+        build.operation = "bulk_load";
+    } else {
+        for (const Point &p : points) tree.insert(p);
+        build.operation = "insert";
+    }
+    build.totalMs = microsSince(start) / 1000.0;
+    build.count = n;
+    build.throughput = build.totalMs > 0 ? 1000.0 * n / build.totalMs : 0.0;
+    out.push_back(build);
+    runQueries(tree, work, base, out);
+}
+
+// La capacidad del RTree es un parametro de plantilla: solo se miden estas
+const size_t kRTreeFanouts[] = {4, 8, 16, 32, 64, 128, 255};
+
+bool supportedFanout(const std::string &policy, size_t maxEntries) {
+    if (policy == "hilbert") return maxEntries >= 2;
+    return std::find(std::begin(kRTreeFanouts), std::end(kRTreeFanouts), maxEntries) != std::end(kRTreeFanouts);
+}
+
+// Construye el arbol con 'policy' y agrega la fila de construccion y las de consultas
+void runCase(const std::vector<Point> &points, const Workload &work, const Result &base, std::vector<Result> &out) {
+    Result build = base;
+    const size_t n = points.size();
+    if (base.policy == "hilbert") {
+        HilbertRTree tree(boundsOf(points), base.maxEntries);
+        auto start = Clock::now();
+        for (const Point &p : points) tree.insert(p);
+        build.totalMs = microsSince(start) / 1000.0;
+        build.operation = "insert";
+        build.count = n;
+        build.throughput = build.totalMs > 0 ? 1000.0 * n / build.totalMs : 0.0;
+        out.push_back(build);
+        runQueries(tree, work, base, out);
+        return;
+    }
+
+    switch (base.maxEntries) {
+    case 4: runRTreeCase<4>(points, work, base, out); break;
+    case 8: runRTreeCase<8>(points, work, base, out); break;
+    case 16: runRTreeCase<16>(points, work, base, out); break;
+    case 32: runRTreeCase<32>(points, work, base, out); break;
+    case 64: runRTreeCase<64>(points, work, base, out); break;
+    case 128: runRTreeCase<128>(points, work, base, out); break;
+    case 255: runRTreeCase<255>(points, work, base, out); break;
+    }
+}
+
+// -------------------------------
+// Salida
+// -------------------------------
+void printHeader() {
+    std::cout << std::left << std::setw(10) << "dist" << std::right << std::setw(11) << "points"
+              << std::setw(9) << "policy" << std::setw(5) << "M" << std::setw(11) << "op"
+              << std::setw(9) << "param" << std::setw(12) << "total ms" << std::setw(13) << "ops/s"
+              << std::setw(11) << "p50 us" << std::setw(11) << "p99 us" << std::setw(11) << "results" << "\n";
+}
+
+void printRow(const Result &r) {
+    std::cout << std::left << std::setw(10) << r.distribution << std::right << std::setw(11) << r.points
+              << std::setw(9) << r.policy << std::setw(5) << r.maxEntries << std::setw(11) << r.operation
+              << std::setw(9) << std::defaultfloat << std::setprecision(3) << r.param
+              << std::setw(12) << std::fixed << std::setprecision(1) << r.totalMs
+              << std::setw(13) << std::setprecision(0) << r.throughput
+              << std::setw(11) << std::setprecision(2) << r.p50 << std::setw(11) << r.p99
+              << std::setw(11) << std::setprecision(1) << r.avgResults << std::defaultfloat << "\n";
+}
+
+std::string toCsv(const std::vector<Result> &results) {
+    std::ostringstream os;
+    os << std::setprecision(6)
+       << "distribution,points,policy,max_entries,operation,param,count,total_ms,throughput_per_s,p50_us,p99_us,"
+          "avg_results,avg_nodes_visited\n";
+    for (const Result &r : results) {
+        os << r.distribution << "," << r.points << "," << r.policy << "," << r.maxEntries << "," << r.operation
+           << "," << r.param << "," << r.count << "," << r.totalMs << "," << r.throughput << "," << r.p50 << ","
+           << r.p99 << "," << r.avgResults << "," << r.avgNodesVisited << "\n";
+    }
+    return os.str();
+}
+
+std::string toJson(const std::vector<Result> &results) {
+    std::ostringstream os;
+    os << std::setprecision(6) << "{\n  \"benchmark\": \"rtree\",\n";
+#if defined(NDEBUG)
+    os << "  \"build_type\": \"release\",\n";
+#else
+    os << "  \"build_type\": \"debug\",\n";
+#endif
+#if defined(RTREE_SIMD)
+    os << "  \"simd\": true,\n";
+#else
+    os << "  \"simd\": false,\n";
+#endif
+    os << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        os << "    {\"distribution\": \"" << r.distribution << "\", \"points\": " << r.points
+           << ", \"policy\": \"" << r.policy << "\", \"max_entries\": " << r.maxEntries
+           << ", \"operation\": \"" << r.operation << "\", \"param\": " << r.param
+           << ", \"count\": " << r.count << ", \"total_ms\": " << r.totalMs
+           << ", \"throughput_per_s\": " << r.throughput << ", \"p50_us\": " << r.p50
+           << ", \"p99_us\": " << r.p99 << ", \"avg_results\": " << r.avgResults
+           << ", \"avg_nodes_visited\": " << r.avgNodesVisited << "}"
+           << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+    return os.str();
+}
+
+std::vector<std::string> splitList(const std::string &s) {
+    std::vector<std::string> items;
+    std::stringstream ss(s);
+    for (std::string item; std::getline(ss, item, ',');)
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t minInput = 10000, maxInput = 1000000;
+    size_t insertMax = 10000000;  // sobre esto solo se mide la carga masiva
+    size_t queryCount = 200;
+    std::vector<std::string> fanouts{"8", "16", "32", "64", "128"};
+    std::vector<std::string> policies{"classic", "rstar", "str", "hilbert"};
+    std::vector<std::string> dists{"uniform", "gaussian", "zipf", "line"};
+    std::string csvPath, jsonPath = "rtree_bench.json";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--min" && i + 1 < argc) minInput = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--max" && i + 1 < argc) maxInput = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--insert-max" && i + 1 < argc) insertMax = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--queries" && i + 1 < argc) queryCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--fanouts" && i + 1 < argc) fanouts = splitList(argv[++i]);
+        else if (arg == "--policies" && i + 1 < argc) policies = splitList(argv[++i]);
+        else if (arg == "--dists" && i + 1 < argc) dists = splitList(argv[++i]);
+        else if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            std::cerr << "Uso: " << argv[0] << " [--min N] [--max N] [--fanouts 8,16,...] [--policies classic,rstar,str,hilbert]"
+                      << " [--dists uniform,gaussian,zipf,line] [--queries Q] [--insert-max N] [--csv archivo] [--json archivo]\n";
+            return 1;
+        }
+    }
+
+    Workload work;
+    work.selectivities = {0.0001, 0.001, 0.01};
+    work.ks = {1, 10, 100};
+
+    std::vector<Result> results;
+    printHeader();
+    for (size_t n = std::max<size_t>(1, minInput); n <= maxInput; n *= 10) {
+        for (const std::string &dist : dists) {
+            std::mt19937 gen(1234);
+            std::vector<Point> points = makeInput(dist, n, gen);
+            std::uniform_int_distribution<size_t> pick(0, n - 1);
+            work.centers.clear();
+            for (size_t q = 0; q < queryCount; ++q) work.centers.push_back(points[pick(gen)]);
+
+            for (const std::string &fanout : fanouts) {
+                size_t maxEntries = std::strtoull(fanout.c_str(), nullptr, 10);
+                for (const std::string &policy : policies) {
+                    if (policy != "str" && n > insertMax) continue;
+                    if (!supportedFanout(policy, maxEntries)) {
+                        std::cerr << "maxEntries " << fanout << " no disponible para " << policy
+                                  << " (RTree: 4, 8, 16, 32, 64, 128 o 255), se omite\n";
+                        continue;
+                    }
+                    Result base;
+                    base.distribution = dist;
+                    base.points = n;
+                    base.policy = policy;
+                    base.maxEntries = maxEntries;
+                    size_t first = results.size();
+                    try {
+                        runCase(points, work, base, results);
+                    } catch (const std::exception &e) {
+                        std::cerr << "[EXCEPCION] " << dist << " " << policy << " M=" << maxEntries << " @" << n
+                                  << ": " << e.what() << "\n";
+                    }
+                    for (size_t i = first; i < results.size(); ++i) printRow(results[i]);
+                }
+            }
+        }
+    }
+
+    if (!csvPath.empty()) {
+        std::ofstream out(csvPath);
+        out << toCsv(results);
+        std::cout << "\nResultados CSV en " << csvPath << "\n";
+    }
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        out << toJson(results);
+        std::cout << "Resultados JSON en " << jsonPath << "\n";
+    }
+    return 0;
+}